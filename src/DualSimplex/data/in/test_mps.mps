@@ -0,0 +1,46 @@
+NAME          TEST
+ROWS
+ N  COST
+ E  R1
+ E  R2
+ E  R3
+ E  R4
+ E  R5
+ E  R6
+COLUMNS
+    X1         R1                    1
+    X1         R3                    2
+    X1         R4                    1
+    X1         R5                    1
+    X1         R6                    3
+    X2         COST                -1
+    X2         R1                    2
+    X2         R2                    3
+    X2         R3                    4
+    X2         R4                   -1
+    X2         R5                    5
+    X2         R6                    6
+    X3         COST                -5
+    X3         R1                   -1
+    X3         R2                    4
+    X3         R3                   -2
+    X3         R4                   -5
+    X3         R5                    3
+    X3         R6                   -3
+    X4         COST                 1
+    X4         R1                    1
+    X4         R2                   -1
+    X4         R3                    2
+    X4         R4                    2
+    X4         R6                    3
+    X5         R2                    1
+    X5         R4                   -1
+    X5         R5                    1
+RHS
+    RHS       R1                    4
+    RHS       R2                    3
+    RHS       R3                    8
+    RHS       R4                    1
+    RHS       R5                    7
+    RHS       R6                   12
+ENDATA
@@ -0,0 +1,34 @@
+* Maximization with L/G/E rows, ranges (also on E rows, both signs) and bounds
+* Optimum: X1 = 3, X2 = 2, X3 = 2, X4 = 1, X5 = 1, objective 29
+NAME          TESTBOUNDS
+OBJSENSE
+    MAX
+ROWS
+ N  COST
+ L  C1
+ G  C2
+ E  C3
+ E  C4
+COLUMNS
+    X1        COST                 3   C1                   1
+    X1        C2                   1
+    X2        COST                 2   C1                   1
+    X2        C3                   1   C4                   1
+    X3        COST                 4   C1                   1
+    X3        C2                   1   C4                   1
+    X4        COST                 1   C3                  -1
+    X4        C4                   1
+    X5        COST                 2   C1                   1
+RHS
+    RHS       COST                -5
+    RHS       C1                  10   C2                   2
+    RHS       C3                   1   C4                   3
+RANGES
+    RNG       C1                   4   C2                   3
+    RNG       C3                  -2   C4                   2
+BOUNDS
+ UP BND       X1                   4
+ LO BND       X2                   1
+ FX BND       X4                   1
+ BV BND       X5
+ENDATA
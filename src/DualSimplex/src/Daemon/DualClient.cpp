@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Client of the DualSimplex daemon (--daemon=SOCKET) and load generator.
+ *
+ * DualSimplexClient SOCKET [--repeat=N] [--connections=K] FILE...
+ *
+ * Each connection sends every .dat FILE N times, one problem at a time waiting for its reply.
+ * With a single connection and no repetition the replies are printed, otherwise only the latency statistics.
+ */
+
+using namespace std;
+
+static int connectDaemon(const char *socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        cerr << "Failed to connect to '" << socketPath << "': " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+static bool sendAll(const int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = write(fd, data.data() + sent, data.size() - sent);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " SOCKET [--repeat=N] [--connections=K] FILE..." << endl;
+        return EXIT_FAILURE;
+    }
+
+    const char *socketPath = argv[1];
+    unsigned long repeat = 1;
+    unsigned long connections = 1;
+    vector<string> problems;
+    for (int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeat = max(strtoul(argv[i] + 9, NULL, 10), 1UL);
+        } else if (strncmp(argv[i], "--connections=", 14) == 0) {
+            connections = max(strtoul(argv[i] + 14, NULL, 10), 1UL);
+        } else {
+            ifstream fin(argv[i]);
+            if (!fin.is_open()) {
+                cerr << "Failed to open '" << argv[i] << "'." << endl;
+                return EXIT_FAILURE;
+            }
+            stringstream ss;
+            ss << fin.rdbuf() << "\n";
+            problems.push_back(ss.str());
+        }
+    }
+
+    const bool printReplies = repeat == 1 && connections == 1;
+    vector<vector<double>> latencies(connections);
+    atomic<bool> failed(false);
+
+    const auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (unsigned long c = 0; c < connections; c++) {
+        threads.emplace_back([&, c]() {
+            const int fd = connectDaemon(socketPath);
+            FILE *fin = fdopen(fd, "r");
+            char *line = NULL;
+            size_t capacity = 0;
+            for (unsigned long r = 0; r < repeat; r++) {
+                for (const string& problem : problems) {
+                    const auto sent = chrono::steady_clock::now();
+                    if (!sendAll(fd, problem) || getline(&line, &capacity, fin) < 0) {
+                        failed = true;
+                        return;
+                    }
+                    latencies[c].push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - sent).count());
+                    if (printReplies) {
+                        fputs(line, stdout);
+                    }
+                }
+            }
+            free(line);
+            shutdown(fd, SHUT_WR);
+            fclose(fin);
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    const double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> all;
+    for (const vector<double>& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    sort(all.begin(), all.end());
+    if (!all.empty()) {
+        double sum = 0.0;
+        for (const double l : all) {
+            sum += l;
+        }
+        cerr << all.size() << " requests in " << elapsed << " s (" << all.size() / elapsed << " req/s), latency ms:"
+             << " avg " << sum / all.size()
+             << " p50 " << all[all.size() / 2]
+             << " p99 " << all[min(all.size() - 1, all.size() * 99 / 100)]
+             << " max " << all.back() << endl;
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+#include "DualDaemon.hpp"
+#include "utils.hpp"
+#include <assert.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define DAEMON_SOCKETS
+#endif
+
+using namespace std;
+
+DualDaemon::DualDaemon(const DualSolverOptions& options, const unsigned int workersCount) {
+    this->options = options;
+    for (unsigned int k = 0; k < MAX(workersCount, 1U); k++) {
+        solvers.push_back(new DualSolver(options));
+    }
+}
+
+void DualDaemon::serve(DualSolver *solver, FILE *fin, FILE *fout) {
+    TableauFilesManager *const tableauInOut = solver->getTableauFilesManager();
+    while (true) {
+        TableauReadStatus read;
+        try {
+            read = solver->loadTableau(fin);
+        } catch (const bad_alloc&) {
+            // Sizes too big to be allocated
+            read = TableauReadStatus::MALFORMED;
+        }
+        // A connection idle for too long fails reading (see runWorker)
+        const bool timedOut = ferror(fin) && (errno == EAGAIN || errno == EWOULDBLOCK);
+        if (read == TableauReadStatus::END && !timedOut) {
+            return;
+        } else if (read != TableauReadStatus::READ) {
+            // The rest of the stream can't be split in problems anymore
+            tableauInOut->writeErrorRecord(fout, timedOut ? "timeout" : "malformed");
+            return;
+        }
+
+        const DualSolverStatus status = solver->startDualSimplex();
+        tableauInOut->writeSolutionRecord(fout, getStatusName(status));
+    }
+}
+
+void DualDaemon::serveStream(FILE *fin, FILE *fout) {
+    serve(solvers[0], fin, fout);
+}
+
+void DualDaemon::runWorker(DualSolver *solver) {
+#ifdef DAEMON_SOCKETS
+    while (true) {
+        int fd;
+        {
+            unique_lock<mutex> lock(connectionsMutex);
+            connectionsAvailable.wait(lock, [this]() { return stopping || !connections.empty(); });
+            if (connections.empty()) {
+                return;
+            }
+            fd = connections.front();
+            connections.pop_front();
+            activeConnections.push_back(fd);
+        }
+
+        // A connection keeps its worker until it is closed, so an idle one is closed after a while to free it
+        timeval timeout = { DAEMON_IDLE_TIMEOUT_SECONDS, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        FILE *fin = fdopen(fd, "r");
+        FILE *fout = fdopen(dup(fd), "w");
+        assert(fin != NULL && fout != NULL);
+        serve(solver, fin, fout);
+        {
+            // Removed before closing, so that a stop can't shut down a reused descriptor
+            lock_guard<mutex> lock(connectionsMutex);
+            activeConnections.erase(find(activeConnections.begin(), activeConnections.end(), fd));
+        }
+        fclose(fout);
+        fclose(fin);
+    }
+#else
+    (void) solver;
+#endif
+}
+
+void DualDaemon::serveSocket(const char *socketPath) {
+#ifdef DAEMON_SOCKETS
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        cerr << "Socket path '" << socketPath << "' is too long." << endl;
+        return;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    const int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(listenFd >= 0);
+    unlink(socketPath);
+    if (bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+            || listen(listenFd, SOMAXCONN) != 0) {
+        cerr << "Failed to listen on '" << socketPath << "': " << strerror(errno) << endl;
+        close(listenFd);
+        return;
+    }
+    // A client closing its connection before reading the replies must not stop the daemon
+    signal(SIGPIPE, SIG_IGN);
+
+    stopping = false;
+    for (DualSolver *solver : solvers) {
+        workers.emplace_back(&DualDaemon::runWorker, this, solver);
+    }
+
+    pollfd listenPoll = { listenFd, POLLIN, 0 };
+    while (options.cancellationToken == nullptr || !options.cancellationToken->isCancelled()) {
+        // Wakes up periodically to check the cancellation token
+        if (poll(&listenPoll, 1, DAEMON_POLL_MILLISECONDS) <= 0) {
+            continue;
+        }
+        const int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        {
+            lock_guard<mutex> lock(connectionsMutex);
+            connections.push_back(fd);
+        }
+        connectionsAvailable.notify_one();
+    }
+
+    {
+        // Connections not served yet are closed, the ones being served stop reading (a solve is cancelled by the token)
+        lock_guard<mutex> lock(connectionsMutex);
+        stopping = true;
+        for (const int fd : connections) {
+            close(fd);
+        }
+        connections.clear();
+        for (const int fd : activeConnections) {
+            shutdown(fd, SHUT_RD);
+        }
+    }
+    connectionsAvailable.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    close(listenFd);
+    unlink(socketPath);
+#else
+    cerr << "Unix domain sockets are not supported on this platform ('" << socketPath << "')." << endl;
+#endif
+}
+
+DualDaemon::~DualDaemon(void) {
+    for (DualSolver *solver : solvers) {
+        delete solver;
+    }
+}
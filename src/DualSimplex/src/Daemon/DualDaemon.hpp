@@ -0,0 +1,47 @@
+#ifndef __DUAL_DAEMON__HPP
+#define __DUAL_DAEMON__HPP
+
+#include "DualSolver.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Long running solver: reads .dat problems one after the other from a stream (or from the connections to a Unix domain
+ * socket) and replies to each one with a line written by TableauFilesManager::writeSolutionRecord, no file is written.
+ * A malformed problem is replied with an error line and ends only its stream (connection), the daemon goes on.
+ * Every worker thread keeps its own DualSolver, so the tableau buffers are reused from a problem to the next one.
+ * A connection is served by a single worker until it is closed, or until it is idle for DAEMON_IDLE_TIMEOUT_SECONDS.
+ */
+class DualDaemon {
+
+public:
+    DualDaemon(const DualSolverOptions& options, const unsigned int workersCount = 1);
+    // Serves problems read from fin until it is over or a problem is malformed
+    void serveStream(FILE *fin, FILE *fout);
+    // Serves the connections to socketPath until the cancellation token of the options is cancelled
+    void serveSocket(const char *socketPath);
+    ~DualDaemon(void);
+
+private:
+    DualSolverOptions options;
+    std::vector<DualSolver *> solvers;
+    std::vector<std::thread> workers;
+
+    // Accepted connections waiting for a worker
+    std::deque<int> connections;
+    // Connections being served, shut down on stop so that workers waiting for a problem return
+    std::vector<int> activeConnections;
+    std::mutex connectionsMutex;
+    std::condition_variable connectionsAvailable;
+    bool stopping = false;
+
+    void serve(DualSolver *solver, FILE *fin, FILE *fout);
+    void runWorker(DualSolver *solver);
+
+};
+
+#endif // __DUAL_DAEMON__HPP
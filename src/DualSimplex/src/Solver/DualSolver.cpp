@@ -1,44 +1,62 @@
 #include "DualSolver.hpp"
 #include "utils.hpp"
+#include <algorithm>
 #include <assert.h>
 #include <stdlib.h>
 #include <limits>
 
 using namespace std;
 
-DualSolver::DualSolver(const char *filePath) {
-    tableauInOut = new TableauFilesManager(&tableau, filePath);
-    tableauInOut->readTableau();
+void DualSolver::setOptions(const DualSolverOptions& options) {
+    this->options = options;
+    // 0 would divide by zero, it means every iteration as 1
+    this->options.progressPeriod = MAX(options.progressPeriod, 1UL);
+}
 
-    Eigen::VectorXd knownTermsRealPart = tableau.knownTermsCol.real();
-    Eigen::MatrixXd equationsMatrix(tableau.coeffMatrix.rows(), tableau.coeffMatrix.cols() + 1);
-    equationsMatrix.col(0) = knownTermsRealPart;
-    equationsMatrix.block(0, 1, tableau.coeffMatrix.rows(), tableau.coeffMatrix.cols()) = tableau.coeffMatrix;
+DualSolver::DualSolver(const char *filePath, const DualSolverOptions& options) {
+    setOptions(options);
+    randomGenerator.seed(options.seed);
+    tableauInOut = new TableauFilesManager(&tableau, filePath, options.outputFormat);
+    readStatus = tableauInOut->readTableau();
+    if (readStatus == TableauReadStatus::READ) {
+        deleteDependentRows();
+    }
+}
 
-    vector<Eigen::Index> indicesRows = getDependentRows(equationsMatrix);
+DualSolver::DualSolver(const DualSolverOptions& options) {
+    setOptions(options);
+    this->options.outputFormat = OutputFormat::NONE;
+    reuseStorage = true;
+    tableauInOut = new TableauFilesManager(&tableau);
+}
 
-    if (indicesRows.size() > 0) {
-        Eigen::MatrixXd newCoeffMatrix(tableau.coeffMatrix.rows() - indicesRows.size(), tableau.coeffMatrix.cols());
-        Eigen::ArrayXcd newKnownTermsCol(tableau.knownTermsCol.size() - indicesRows.size());
-        Eigen::ArrayXindex newVarInBaseCol(tableau.varInBaseCol.size() - indicesRows.size());
-        Eigen::Index resRowIdx = 0;
-
-        for (Eigen::Index i = 0; i < tableau.coeffMatrix.rows(); i++) {
-            // Check if the current row index should be deleted
-            if (find(indicesRows.begin(), indicesRows.end(), i) != indicesRows.end()) {
-                continue; // Skip this row
-            }
+TableauReadStatus DualSolver::loadTableau(FILE *fin) {
+    randomGenerator.seed(options.seed);
+    readStatus = tableauInOut->readTableau(fin);
+    if (readStatus == TableauReadStatus::READ) {
+        deleteDependentRows();
+    }
+    return readStatus;
+}
 
-            // Copy the current row to the newCoeffMatrix matrix
-            newCoeffMatrix.row(resRowIdx) = tableau.coeffMatrix.row(i);
-            newKnownTermsCol[resRowIdx] = tableau.knownTermsCol[i];
-            newVarInBaseCol[i] = tableau.varInBaseCol[i];
-            resRowIdx++;
-        }
+void DualSolver::deleteDependentRows(void) {
+    const Eigen::Index m = tableau.getM();
+    const Eigen::Index n = tableau.getN() + 1;
+    if (equationsStorage.rows() < m || equationsStorage.cols() < n) {
+        equationsStorage.resize(MAX(equationsStorage.rows(), m), MAX(equationsStorage.cols(), n));
+    }
+    Eigen::Block<Eigen::MatrixXd> equationsMatrix = equationsStorage.topLeftCorner(m, n);
+    equationsMatrix.col(0) = tableau.knownTermsCol.real();
+    equationsMatrix.rightCols(tableau.getN()) = tableau.coeffMatrix();
+
+    vector<Eigen::Index> indicesRows = getDependentRows(equationsMatrix);
+    if (!reuseStorage) {
+        // A single problem is solved, the work matrix would only double the memory of the solve
+        equationsStorage.resize(0, 0);
+    }
 
-        tableau.coeffMatrix = newCoeffMatrix;
-        tableau.knownTermsCol = newKnownTermsCol;
-        tableau.varInBaseCol = newVarInBaseCol;
+    if (indicesRows.size() > 0) {
+        tableau.deleteRows(indicesRows);
 
         assert(tableau.isFeasible());
         tableauInOut->printTableau("Deleted linearly dependent rows.", "MAX RANK");
@@ -46,13 +64,44 @@ DualSolver::DualSolver(const char *filePath) {
     assert(tableau.isValid());
 }
 
-void DualSolver::startDualSimplex(void) {
+DualSolver::DualSolver(const DualSolver& loaded, const DualSolverOptions& options, const string& outFolderPath) {
+    setOptions(options);
+    randomGenerator.seed(options.seed);
+    tableau = loaded.tableau;
+    readStatus = loaded.readStatus;
+    tableauInOut = new TableauFilesManager(&tableau, *loaded.tableauInOut, outFolderPath, options.outputFormat);
+}
+
+const char *getStatusName(const DualSolverStatus status) {
+    switch (status) {
+        case DualSolverStatus::OPTIMAL:
+            return "optimal";
+        case DualSolverStatus::PRIMAL_INFEASIBLE:
+            return "infeasible";
+        case DualSolverStatus::PRIMAL_UNBOUNDED:
+            return "unbounded";
+        case DualSolverStatus::ITERATION_LIMIT:
+            return "iteration_limit";
+        case DualSolverStatus::TIME_LIMIT:
+            return "time_limit";
+        default:
+            return "cancelled";
+    }
+}
+
+DualSolverStatus DualSolver::startDualSimplex(void) {
+    startTime = chrono::steady_clock::now();
+    iterations = 0;
+    // The solver can be started again after loadTableau
+    trackInfeasibleRows = false;
+    singlePrecision = false;
+    pivotRowColumns.clear();
     bool notBasic = false;
 
     for (Eigen::Index i = 0; i < tableau.getM(); i++) {
         if (tableau.varInBaseCol[i] == 0) {
             for (Eigen::Index j = 0; j < tableau.getN(); j++) {
-                if (isNotZero(tableau.coeffMatrix(i, j))) {
+                if (isNotZero(tableau.coeffMatrix()(i, j))) {
                     doDualPivot(i, j);
                     break;
                 }
@@ -70,61 +119,93 @@ void DualSolver::startDualSimplex(void) {
         tableauInOut->printTableau("Added artificial variable so as to make base dual feasible now (positive costs).", "COSTS POSITIVE");
     }
 
+    initInfeasibleRows();
+    if (options.perturbCosts) {
+        startCostPerturbation();
+    }
+    if (options.mixedPrecision) {
+        startMixedPrecision();
+    }
+
     bool found;
     do {
-        Eigen::dcomplex mostNegativeKnownTerm = Eigen::dcomplex();
-        Eigen::Index row;
-        Eigen::Index varIndex;
-        found = false;
-
-        for (Eigen::Index i = 0; i < tableau.getM(); i++) {
-            // Here exact <>= 0.0 checks wouldn't be correct because knownTerms column could have this very small values
-            if (isLessThanZero(tableau.knownTermsCol[i].imag())
-                    || (isZero(tableau.knownTermsCol[i].imag())
-                        && isLessThanZero(tableau.knownTermsCol[i].real()))) {
-                if (!found) {
-                    mostNegativeKnownTerm = tableau.knownTermsCol[i];
-                    row = i;
-                    varIndex = tableau.varInBaseCol[i];
-                    found = true;
-                // This is the application of the Bland Dual rule
-                } else if (tableau.varInBaseCol[i] < varIndex) {
-                    mostNegativeKnownTerm = tableau.knownTermsCol[i];
-                    row = i;
-                    varIndex = tableau.varInBaseCol[i];
-                }
-            }
-        }
+        const Eigen::Index row = selectLeavingRow();
+        found = row >= 0;
 
         if (found) {
-            double min = numeric_limits<double>::infinity();
-            Eigen::Index col;
-
-            for (Eigen::Index j = 0; j < tableau.getN(); j++) {
-                if (isLessThanZero(tableau.coeffMatrix(row, j))) {
-                    const double tmp = tableau.redCostsRow[j] / abs(tableau.coeffMatrix(row, j));
-                    if (tmp < min) {
-                        min = tmp;
-                        col = j;
-                    }
+            DualSolverStatus status;
+            if (isInterrupted(status)) {
+                if (singlePrecision) {
+                    doMixedPrecisionRefinement(true);
+                }
+                if (costsPerturbed) {
+                    removeCostPerturbation();
                 }
+                if (options.printInterrupted) {
+                    stringstream ss;
+                    ss << "Interrupted (" << getStatusName(status) << ") after " << iterations << " iterations.";
+                    tableauInOut->printSolution(getStatusName(status), ss.str());
+                }
+                return status;
             }
 
-            if (min != numeric_limits<double>::infinity()) {
+            const Eigen::Index col = doDualRatioTest(row);
+
+            if (col >= 0) {
 #ifdef PRINT_ITERATIONS
                 stringstream ss;
                 ss << "Pivot in (x" << tableau.varInBaseCol[row] << ", x" << col + 1 << ")";
-                doDualPivot(row, col);
+                doDualPivot(row, col, &pivotRowColumns);
                 ss << " => (x" << tableau.varInBaseCol[row] << ", x" << col + 1 << ").";
                 const string summary = ss.str();
+                if (singlePrecision) {
+                    tableau.coeffMatrix() = coeffMatrixSingle.cast<double>();
+                }
                 tableauInOut->printTableau(summary, "ITERATION");
 #else
-                doDualPivot(row, col);
+                doDualPivot(row, col, &pivotRowColumns);
 #endif
+                iterations++;
+                if (costsPerturbed) {
+                    doCostShifting();
+                }
+                if (options.progressCallback && iterations % options.progressPeriod == 0) {
+                    notifyProgress();
+                }
+                if (singlePrecision && ++pivotsSinceRefinement >= refinementPeriod) {
+                    doMixedPrecisionRefinement(false);
+                }
+            } else if (singlePrecision) {
+                // The verdict is given only in double precision, iterations go on from the refined tableau
+                doMixedPrecisionRefinement(true);
             } else {
-                tableauInOut->printTableau("Primal infeasible (Dual unbounded).", "SOLUTION");
-                return;
+                // The verdict does not depend on costs
+                if (costsPerturbed) {
+                    removeCostPerturbation();
+                }
+                tableauInOut->printSolution(getStatusName(DualSolverStatus::PRIMAL_INFEASIBLE), "Primal infeasible (Dual unbounded).");
+                return DualSolverStatus::PRIMAL_INFEASIBLE;
+            }
+        } else if (singlePrecision) {
+            // Validates the optimal tableau, if something is still infeasible iterations go on in double precision
+            doMixedPrecisionRefinement(true);
+            found = true;
+        } else if (costsPerturbed) {
+            // Original costs can make the base dual infeasible, primal iterations bring it back to optimality
+            removeCostPerturbation();
+            DualSolverStatus status;
+            if (!doPrimalCleanup(status)) {
+                if (status == DualSolverStatus::PRIMAL_UNBOUNDED) {
+                    tableauInOut->printSolution(getStatusName(status), "Primal unbounded (found by primal iterations after cost perturbation removal).");
+                } else if (options.printInterrupted) {
+                    stringstream ss;
+                    ss << "Interrupted (" << getStatusName(status) << ") after " << iterations << " iterations (primal cleanup).";
+                    tableauInOut->printSolution(getStatusName(status), ss.str());
+                }
+                return status;
             }
+            // Checks again the known terms, in case of numerical problems dual iterations go on
+            found = true;
         }
     } while (found);
 
@@ -134,8 +215,8 @@ void DualSolver::startDualSimplex(void) {
             stringstream ss;
             ss << "Primal unbounded (in Dual solution artificial variable x" << tableau.getN() << " is not in base).";
             const string summary = ss.str();
-            tableauInOut->printTableau(summary, "SOLUTION");
-            return;
+            tableauInOut->printSolution(getStatusName(DualSolverStatus::PRIMAL_UNBOUNDED), summary);
+            return DualSolverStatus::PRIMAL_UNBOUNDED;
         }
         // Otherwise it cannot be `tableau.redCostsRow[tableau.getN() - 1] < 0.0`, so it
         // is not necessary to verify this case because of dual conditions
@@ -145,12 +226,45 @@ void DualSolver::startDualSimplex(void) {
 
     // Here 0.0 check is with tolerance because of possible calculation problems
     if (isZero(tableau.objFunc.imag())) {
-        tableauInOut->printTableau("Optimal solution reached (Primal solution = Dual solution).", "SOLUTION");
+        tableauInOut->printSolution(getStatusName(DualSolverStatus::OPTIMAL), "Optimal solution reached (Primal solution = Dual solution).");
+        return DualSolverStatus::OPTIMAL;
     } else {
-        tableauInOut->printTableau("Primal infeasible (Dual unbounded).", "SOLUTION");
+        tableauInOut->printSolution(getStatusName(DualSolverStatus::PRIMAL_INFEASIBLE), "Primal infeasible (Dual unbounded).");
+        return DualSolverStatus::PRIMAL_INFEASIBLE;
     }
 }
 
+// Checked before every iteration, so it has to be cheap
+bool DualSolver::isInterrupted(DualSolverStatus& status) {
+    if (options.cancellationToken != nullptr && options.cancellationToken->isCancelled()) {
+        status = DualSolverStatus::CANCELLED;
+        return true;
+    }
+    if (options.maxIterations > 0 && iterations >= options.maxIterations) {
+        status = DualSolverStatus::ITERATION_LIMIT;
+        return true;
+    }
+    if (options.timeLimitSeconds > 0.0
+            && chrono::duration<double>(chrono::steady_clock::now() - startTime).count() >= options.timeLimitSeconds) {
+        status = DualSolverStatus::TIME_LIMIT;
+        return true;
+    }
+    return false;
+}
+
+void DualSolver::notifyProgress(void) {
+    DualSolverProgress progress;
+    progress.iteration = iterations;
+    progress.objFunc = -tableau.objFunc;
+    progress.primalInfeasibility = Eigen::dcomplex();
+    for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+        if (complexIsLessThanZero(tableau.knownTermsCol[i])) {
+            progress.primalInfeasibility -= tableau.knownTermsCol[i];
+        }
+    }
+    options.progressCallback(progress);
+}
+
 bool DualSolver::doDualCostsValidation(void) {
     Eigen::Index index;
 
@@ -165,73 +279,470 @@ bool DualSolver::doDualCostsValidation(void) {
     }
 
     if (found) {
-        Eigen::Index size1 = tableau.coeffMatrix.rows();
-        Eigen::Index size2 = tableau.coeffMatrix.cols();
+        tableau.addRowAndCol();
 
-        tableau.coeffMatrix.conservativeResize(size1 + 1, size2 + 1);
-        tableau.coeffMatrix.row(size1).setZero();
-        tableau.coeffMatrix.col(size2).setZero();
-
-        size1 = tableau.redCostsRow.size();
-        tableau.redCostsRow.conservativeResize(size1 + 1);
-        tableau.redCostsRow[size1] = 0.0;
-
-        size1 = tableau.knownTermsCol.size();
-        tableau.knownTermsCol.conservativeResize(size1 + 1);
-        tableau.knownTermsCol[size1] = Eigen::dcomplex(0.0, 1.0);
-
-        size1 = tableau.coeffMatrix.rows() - 1;
-        size2 = tableau.coeffMatrix.cols() - 1;
-        for (Eigen::Index j = 0; j < size2; j++) {
+        const Eigen::Index artificialRow = tableau.getM() - 1;
+        const Eigen::Index artificialCol = tableau.getN() - 1;
+        tableau.knownTermsCol[artificialRow] = Eigen::dcomplex(0.0, 1.0);
+        for (Eigen::Index j = 0; j < artificialCol; j++) {
             // Here exact 0.0 check is valid because every cost must be positive
             if (tableau.redCostsRow[j] != 0.0) {
-                tableau.coeffMatrix(size1, j) = 1.0;
+                tableau.coeffMatrix()(artificialRow, j) = 1.0;
             }
         }
-        tableau.coeffMatrix(size1, size2) = 1.0;
+        tableau.coeffMatrix()(artificialRow, artificialCol) = 1.0;
+        tableau.setInBase(artificialRow, artificialCol + 1);
 
-        size1 = tableau.varInBaseCol.size();
-        tableau.varInBaseCol.conservativeResize(size1 + 1);
-        tableau.varInBaseCol[size1] = tableau.getN() + 1;
-
-        doDualPivot(tableau.coeffMatrix.rows() - 1, index);
+        doDualPivot(artificialRow, index);
         return false;
     }
 
     return true;
 }
 
-void DualSolver::doDualPivot(const Eigen::Index r, const Eigen::Index c) {
+void DualSolver::doDualPivot(const Eigen::Index r, const Eigen::Index c, const std::vector<Eigen::Index> *rowColumns) {
+    if (singlePrecision) {
+        doDualPivot(coeffMatrixSingle, r, c, rowColumns);
+    } else {
+        Eigen::Block<Eigen::MatrixXd> coeffMatrix = tableau.coeffMatrix();
+        doDualPivot(coeffMatrix, r, c, rowColumns);
+    }
+}
+
+template<typename Matrix>
+void DualSolver::doDualPivot(Matrix& coeffMatrix, const Eigen::Index r, const Eigen::Index c,
+                             const std::vector<Eigen::Index> *rowColumns) {
     // Here 0.0 check is correct because this assertion is more theoretical than practical
-    assert(tableau.coeffMatrix(r, c) != 0.0);
+    assert(coeffMatrix(r, c) != 0.0);
 
-    // Adapts target row
-    if (tableau.coeffMatrix(r, c) != 1.0) {
-        tableau.knownTermsCol[r] /= tableau.coeffMatrix(r, c);
-        tableau.coeffMatrix.row(r) /= tableau.coeffMatrix(r, c);
-        tableau.coeffMatrix(r, c) = 1.0;
-    }
+    // Columns with a zero coefficient in row r don't change, the list of the others (if given) skips them
+    const bool sparse = rowColumns != nullptr && !rowColumns->empty() &&
+                        rowColumns->size() <= SPARSE_PIVOT_MAX_DENSITY * tableau.getN();
+    if (sparse) {
+        doDualPivotSparse(coeffMatrix, r, c, *rowColumns);
+    } else {
+        // Adapts target row
+        if (coeffMatrix(r, c) != 1.0) {
+            tableau.knownTermsCol[r] /= static_cast<double>(coeffMatrix(r, c));
+            coeffMatrix.row(r) /= coeffMatrix(r, c);
+            coeffMatrix(r, c) = 1.0;
+        }
 
-    // Updates reduced costs row
-    if (tableau.redCostsRow[c] != 0.0) {
-        tableau.objFunc += -tableau.redCostsRow[c] * tableau.knownTermsCol[r];
-        tableau.redCostsRow += -tableau.redCostsRow[c] * tableau.coeffMatrix.row(r).array();
-        tableau.redCostsRow[c] = 0.0;
+        // Updates reduced costs row
+        if (tableau.redCostsRow[c] != 0.0) {
+            tableau.objFunc += -tableau.redCostsRow[c] * tableau.knownTermsCol[r];
+            const double redCost = tableau.redCostsRow[c];
+            for (Eigen::Index j = 0; j < tableau.getN(); j++) {
+                tableau.setRedCost(j, tableau.redCostsRow[j] + -redCost * static_cast<double>(coeffMatrix(r, j)));
+            }
+            tableau.setRedCost(c, 0.0);
+        }
     }
 
     // Updates every other row
-    for (Eigen::Index i = 0; i < tableau.coeffMatrix.rows(); i++) {
+    for (Eigen::Index i = 0; i < coeffMatrix.rows(); i++) {
         // Here approximate != 0.0 check may cause problems
         // Probably, not sure about this, because certain rows aren't updated correctly
         // Verified in practice
-        if ((i != r) && (tableau.coeffMatrix(i, c) != 0.0)) {
-            tableau.knownTermsCol[i] += -tableau.coeffMatrix(i, c) * tableau.knownTermsCol[r];
-            tableau.coeffMatrix.row(i) += -tableau.coeffMatrix(i, c) * tableau.coeffMatrix.row(r);
-            tableau.coeffMatrix(i, c) = 0.0;
+        if ((i != r) && (coeffMatrix(i, c) != 0.0)) {
+            tableau.knownTermsCol[i] += -static_cast<double>(coeffMatrix(i, c)) * tableau.knownTermsCol[r];
+            if (!sparse) {
+                coeffMatrix.row(i) += -coeffMatrix(i, c) * coeffMatrix.row(r);
+            }
+            coeffMatrix(i, c) = 0.0;
+            if (trackInfeasibleRows) {
+                updateInfeasibleRow(i);
+            }
+        }
+    }
+
+    tableau.setInBase(r, c + 1);
+    if (trackInfeasibleRows) {
+        updateInfeasibleRow(r);
+    }
+}
+
+/*
+ * Same updates of the coefficients and of the reduced costs done by doDualPivot, but only on the columns in rowColumns.
+ * Columns are updated one at a time (contiguous in memory), the pivot column c is left to doDualPivot.
+ */
+template<typename Matrix>
+void DualSolver::doDualPivotSparse(Matrix& coeffMatrix, const Eigen::Index r, const Eigen::Index c,
+                                   const std::vector<Eigen::Index>& rowColumns) {
+    typedef typename Matrix::Scalar Scalar;
+
+    const Scalar pivot = coeffMatrix(r, c);
+    if (pivot != 1.0) {
+        tableau.knownTermsCol[r] /= static_cast<double>(pivot);
+        for (const Eigen::Index j : rowColumns) {
+            coeffMatrix(r, j) /= pivot;
+        }
+        coeffMatrix(r, c) = 1.0;
+    }
+
+    const double redCost = tableau.redCostsRow[c];
+    if (redCost != 0.0) {
+        tableau.objFunc += -redCost * tableau.knownTermsCol[r];
+        for (const Eigen::Index j : rowColumns) {
+            tableau.setRedCost(j, tableau.redCostsRow[j] + -redCost * static_cast<double>(coeffMatrix(r, j)));
+        }
+        tableau.setRedCost(c, 0.0);
+    }
+
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> pivotCol = coeffMatrix.col(c);
+    pivotCol[r] = 0.0;
+    for (const Eigen::Index j : rowColumns) {
+        if (j != c) {
+            coeffMatrix.col(j) -= coeffMatrix(r, j) * pivotCol;
+        }
+    }
+}
+
+// Returns the entering column for leaving row r by the dual ratio test, -1 if there is none (Dual unbounded)
+Eigen::Index DualSolver::doDualRatioTest(const Eigen::Index r) {
+    if (singlePrecision) {
+        return doDualRatioTest(coeffMatrixSingle, r, MIXED_PRECISION_TOLERANCE);
+    } else {
+        return doDualRatioTest(tableau.coeffMatrix(), r, DEFAULT_TOLERANCE);
+    }
+}
+
+template<typename Matrix>
+Eigen::Index DualSolver::doDualRatioTest(const Matrix& coeffMatrix, const Eigen::Index r, const double tolerance) {
+    double min = numeric_limits<double>::infinity();
+    Eigen::Index col = -1;
+    pivotRowColumns.clear();
+
+    for (Eigen::Index j = 0; j < tableau.getN(); j++) {
+        if (options.sparsePivot && coeffMatrix(r, j) != 0.0) {
+            pivotRowColumns.push_back(j);
+        }
+        if (isLessThanZero(coeffMatrix(r, j), tolerance)) {
+            const double tmp = tableau.redCostsRow[j] / abs(coeffMatrix(r, j));
+            if (tmp < min) {
+                min = tmp;
+                col = j;
+            }
+        }
+    }
+
+    if (col < 0) {
+        pivotRowColumns.clear();
+    }
+    return col;
+}
+
+void DualSolver::initInfeasibleRows(void) {
+    infeasibleRows.clear();
+    pricingCandidates.clear();
+    if (options.partialPricing) {
+        // Candidates are kept up to date by selectLeavingRow, pivots don't update infeasibleRows
+        trackInfeasibleRows = false;
+        return;
+    }
+    infeasibleRowsKeys.assign(tableau.getM(), InfeasibleRowKey(0.0, 0.0, 0, -1));
+    for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+        updateInfeasibleRow(i);
+    }
+    trackInfeasibleRows = true;
+}
+
+void DualSolver::updateInfeasibleRow(const Eigen::Index i) {
+    if (get<3>(infeasibleRowsKeys[i]) >= 0) {
+        infeasibleRows.erase(infeasibleRowsKeys[i]);
+        get<3>(infeasibleRowsKeys[i]) = -1;
+    }
+    // Here exact <>= 0.0 checks wouldn't be correct because knownTerms column could have this very small values
+    if (complexIsLessThanZero(tableau.knownTermsCol[i])) {
+        infeasibleRowsKeys[i] = getInfeasibleRowKey(i);
+        infeasibleRows.insert(infeasibleRowsKeys[i]);
+    }
+}
+
+DualSolver::InfeasibleRowKey DualSolver::getInfeasibleRowKey(const Eigen::Index i) {
+    switch (options.rowSelectionRule) {
+        case RowSelectionRule::DANTZIG:
+            // The imaginary part (multiple of big M) prevails over the real one
+            return InfeasibleRowKey(tableau.knownTermsCol[i].imag(), tableau.knownTermsCol[i].real(), tableau.varInBaseCol[i], i);
+        case RowSelectionRule::RANDOM:
+            return InfeasibleRowKey(uniform_real_distribution<double>()(randomGenerator), 0.0, tableau.varInBaseCol[i], i);
+        default:
+            return InfeasibleRowKey(0.0, 0.0, tableau.varInBaseCol[i], i);
+    }
+}
+
+void DualSolver::refreshPricingCandidates(void) {
+    pricingKeys.clear();
+    for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+        if (complexIsLessThanZero(tableau.knownTermsCol[i])) {
+            pricingKeys.push_back(getInfeasibleRowKey(i));
+        }
+    }
+    const size_t candidates = MIN(pricingKeys.size(), static_cast<size_t>(PARTIAL_PRICING_CANDIDATES));
+    partial_sort(pricingKeys.begin(), pricingKeys.begin() + candidates, pricingKeys.end());
+    pricingCandidates.clear();
+    for (size_t k = 0; k < candidates; k++) {
+        pricingCandidates.push_back(get<3>(pricingKeys[k]));
+    }
+    pivotsSincePricing = 0;
+}
+
+Eigen::Index DualSolver::selectLeavingRow(void) {
+    if (!options.partialPricing) {
+        return infeasibleRows.empty() ? -1 : get<3>(*infeasibleRows.begin());
+    }
+
+    if (pricingCandidates.empty() || pivotsSincePricing >= PARTIAL_PRICING_PERIOD) {
+        refreshPricingCandidates();
+    }
+    for (int scan = 0; scan < 2; scan++) {
+        // Best candidate still infeasible, the others are dropped
+        Eigen::Index row = -1;
+        InfeasibleRowKey best;
+        size_t kept = 0;
+        for (const Eigen::Index i : pricingCandidates) {
+            if (complexIsLessThanZero(tableau.knownTermsCol[i])) {
+                pricingCandidates[kept++] = i;
+                const InfeasibleRowKey key = getInfeasibleRowKey(i);
+                if (row < 0 || key < best) {
+                    best = key;
+                    row = i;
+                }
+            }
+        }
+        pricingCandidates.resize(kept);
+        if (row >= 0) {
+            pivotsSincePricing++;
+            return row;
+        }
+        // Every candidate became feasible, a full scan tells if some row is still infeasible
+        if (scan == 0) {
+            refreshPricingCandidates();
+        }
+    }
+
+    return -1;
+}
+
+void DualSolver::startMixedPrecision(void) {
+    // The base must be complete to recompute the tableau from it
+    if ((tableau.varInBaseCol <= 0).any()) {
+        return;
+    }
+
+    refinementTableau = tableau;
+    coeffMatrixSingle = tableau.coeffMatrix().cast<float>();
+    refinementBase.resize(tableau.getM(), tableau.getM());
+    refinedBaseCol = tableau.varInBaseCol;
+    refinementPeriod = MAX(MIXED_PRECISION_REFINEMENT_PERIOD, static_cast<unsigned long>(tableau.getM()));
+    pivotsSinceRefinement = 0;
+    singlePrecision = true;
+}
+
+/*
+ * Recomputes in double precision the tableau of the current base from refinementTableau: B^-1 [d|A] for the rows and
+ * c - c_B B^-1 [d|A] for the costs row. If last is true, or the single precision tableau drifted too much from the
+ * recomputed one, iterations go on in double precision. Returns false in case of too much drift.
+ * If the single precision pivots reached a numerically singular base, the tableau is recomputed from the base of the last
+ * refinement instead (the pivots since then are lost) and iterations go on in double precision.
+ * The coefficients are solved in place in tableau.coeffStorage, so no matrix is allocated here.
+ */
+bool DualSolver::doMixedPrecisionRefinement(const bool last) {
+    const Eigen::Index m = tableau.getM();
+    Eigen::ArrayXd baseCosts(m);
+    bool singular = false;
+    while (true) {
+        for (Eigen::Index i = 0; i < m; i++) {
+            refinementBase.col(i) = refinementTableau.coeffMatrix().col(tableau.varInBaseCol[i] - 1);
+            baseCosts[i] = refinementTableau.redCostsRow[tableau.varInBaseCol[i] - 1];
         }
+        refinementLu.compute(refinementBase);
+        // The base of the last refinement was not singular, so this is done at most once
+        if (singular || !(refinementLu.rcond() < MIXED_PRECISION_MIN_RCOND)) {
+            break;
+        }
+        singular = true;
+        for (Eigen::Index i = 0; i < m; i++) {
+            tableau.setInBase(i, refinedBaseCol[i]);
+        }
+    }
+
+    Eigen::Block<Eigen::MatrixXd> coeffMatrix = tableau.coeffMatrix();
+    coeffMatrix = refinementLu.solve(refinementTableau.coeffMatrix());
+    const Eigen::VectorXd knownTermsReal = refinementLu.solve(refinementTableau.knownTermsCol.real().matrix());
+    const Eigen::VectorXd knownTermsImag = refinementLu.solve(refinementTableau.knownTermsCol.imag().matrix());
+    const Eigen::ArrayXd redCostsRow = refinementTableau.redCostsRow
+        - (baseCosts.matrix().transpose() * coeffMatrix).array().transpose();
+
+    // Basic columns are exactly the identity with null costs, as after a pivot
+    for (Eigen::Index i = 0; i < m; i++) {
+        coeffMatrix.col(tableau.varInBaseCol[i] - 1).setZero();
+        coeffMatrix(i, tableau.varInBaseCol[i] - 1) = 1.0;
+    }
+
+    // Relative drift (absolute for values smaller than 1), NaN if the base is numerically singular
+    double drift = ((coeffMatrix.array() - coeffMatrixSingle.cast<double>().array()).abs()
+        / coeffMatrix.array().abs().max(1.0)).maxCoeff();
+    drift = MAX(drift, ((tableau.redCostsRow - redCostsRow).abs() / redCostsRow.abs().max(1.0)).maxCoeff());
+    for (Eigen::Index i = 0; i < m; i++) {
+        const Eigen::dcomplex knownTerm(knownTermsReal[i], knownTermsImag[i]);
+        drift = MAX(drift, abs(tableau.knownTermsCol[i] - knownTerm) / MAX(abs(knownTerm), 1.0));
     }
 
-    tableau.varInBaseCol[r] = c + 1;
+    // Written as a negation so that a NaN drift is a failure too
+    const bool drifted = singular || !(drift <= MIXED_PRECISION_MAX_DRIFT);
+    const bool refined = coeffMatrix.allFinite() && redCostsRow.allFinite()
+        && knownTermsReal.allFinite() && knownTermsImag.allFinite();
+    if (refined) {
+        for (Eigen::Index i = 0; i < m; i++) {
+            tableau.knownTermsCol[i] = Eigen::dcomplex(knownTermsReal[i], knownTermsImag[i]);
+        }
+        tableau.redCostsRow = redCostsRow;
+        for (Eigen::Index i = 0; i < m; i++) {
+            tableau.redCostsRow[tableau.varInBaseCol[i] - 1] = 0.0;
+        }
+        tableau.objFunc = refinementTableau.objFunc - (baseCosts.cast<Eigen::dcomplex>() * tableau.knownTermsCol).sum();
+        tableau.countNegativeCosts();
+        initInfeasibleRows();
+    } else {
+        // Iterations go on from the single precision tableau (known terms and costs are already in double precision)
+        coeffMatrix = coeffMatrixSingle.cast<double>();
+    }
+
+    if (last || drifted) {
+        singlePrecision = false;
+        coeffMatrixSingle.resize(0, 0);
+        refinementTableau = Tableau();
+        if (singular) {
+            tableauInOut->printTableau("Single precision base became singular, iterations go on in double precision from the last refined one.", "PRECISION");
+        } else if (drifted) {
+            stringstream ss;
+            ss << "Single precision tableau drifted by " << drift << ", iterations go on in double precision.";
+            tableauInOut->printTableau(ss.str(), "PRECISION");
+        }
+    } else {
+        refinedBaseCol = tableau.varInBaseCol;
+        coeffMatrixSingle = coeffMatrix.cast<float>();
+        pivotsSinceRefinement = 0;
+    }
+
+    return !drifted;
+}
+
+/*
+ * Adds to the reduced cost of each column out of base a small random positive amount, scaled to the magnitude of the column.
+ * Costs stay positive and ties in the ratio test (degenerate dual steps) become unlikely.
+ */
+void DualSolver::startCostPerturbation(void) {
+    costPerturbation = Eigen::ArrayXd::Zero(tableau.getN());
+    perturbationScale.resize(tableau.getN());
+    Eigen::ArrayXb isInBase = Eigen::ArrayXb::Constant(tableau.getN(), false);
+    for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+        if (tableau.varInBaseCol[i] > 0) {
+            isInBase[tableau.varInBaseCol[i] - 1] = true;
+        }
+    }
+
+    uniform_real_distribution<double> distribution(1.0, 2.0);
+    Eigen::Block<Eigen::MatrixXd> coeffMatrix = tableau.coeffMatrix();
+    for (Eigen::Index j = 0; j < tableau.getN(); j++) {
+        perturbationScale[j] = COST_PERTURBATION_BASE * MAX(1.0, coeffMatrix.col(j).cwiseAbs().maxCoeff());
+        if (!isInBase[j]) {
+            costPerturbation[j] = perturbationScale[j] * distribution(randomGenerator);
+        }
+    }
+
+    tableau.redCostsRow += costPerturbation;
+    tableau.countNegativeCosts();
+    costsPerturbed = true;
+}
+
+// Shifts the reduced costs that became negative (small dual infeasibilities caused by calculations) to a small random
+// positive amount as in startCostPerturbation, shifting them to 0.0 would create again ties in the ratio test
+void DualSolver::doCostShifting(void) {
+    if (tableau.negativeCosts == 0) {
+        return;
+    }
+    uniform_real_distribution<double> distribution(1.0, 2.0);
+    for (Eigen::Index j = 0; j < tableau.getN(); j++) {
+        if (tableau.redCostsRow[j] < 0.0) {
+            const double cost = perturbationScale[j] * distribution(randomGenerator);
+            const double shift = cost - tableau.redCostsRow[j];
+            costPerturbation[j] += shift;
+            tableau.setRedCost(j, cost);
+            // The column is out of base, so its cost in the tableau of the refinement changes in the same way
+            if (singlePrecision) {
+                refinementTableau.redCostsRow[j] += shift;
+            }
+        }
+    }
+}
+
+// Costs row of the current base with the original costs: c - c_B B^-1 A = (c + p) - (c + p)_B B^-1 A - p + p_B B^-1 A
+void DualSolver::removeCostPerturbation(void) {
+    Eigen::Block<Eigen::MatrixXd> coeffMatrix = tableau.coeffMatrix();
+    tableau.redCostsRow -= costPerturbation;
+    for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+        if (tableau.varInBaseCol[i] > 0) {
+            const double basePerturbation = costPerturbation[tableau.varInBaseCol[i] - 1];
+            if (basePerturbation != 0.0) {
+                tableau.redCostsRow += basePerturbation * coeffMatrix.row(i).array().transpose();
+                tableau.objFunc += basePerturbation * tableau.knownTermsCol[i];
+            }
+        }
+    }
+    // Variables in base have exactly null cost, as after a pivot
+    for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+        if (tableau.varInBaseCol[i] > 0) {
+            tableau.redCostsRow[tableau.varInBaseCol[i] - 1] = 0.0;
+        }
+    }
+
+    costPerturbation.resize(0);
+    tableau.countNegativeCosts();
+    costsPerturbed = false;
+}
+
+/*
+ * Primal Simplex iterations with Bland rule from a primal feasible base, till reduced costs are positive.
+ * Returns false if the Primal is unbounded or the iterations are interrupted (limits and cancellation), with the status.
+ */
+bool DualSolver::doPrimalCleanup(DualSolverStatus& status) {
+    Eigen::Block<Eigen::MatrixXd> coeffMatrix = tableau.coeffMatrix();
+    while (true) {
+        Eigen::Index col = -1;
+        for (Eigen::Index j = 0; j < tableau.getN() && col < 0; j++) {
+            if (isLessThanZero(tableau.redCostsRow[j])) {
+                col = j;
+            }
+        }
+        if (col < 0) {
+            return true;
+        }
+        if (isInterrupted(status)) {
+            return false;
+        }
+
+        Eigen::Index row = -1;
+        Eigen::dcomplex min;
+        for (Eigen::Index i = 0; i < tableau.getM(); i++) {
+            if (isMoreThanZero(coeffMatrix(i, col))) {
+                const Eigen::dcomplex ratio = tableau.knownTermsCol[i] / coeffMatrix(i, col);
+                if (row < 0 || complexIsLess(ratio, min)
+                        || (ratio == min && tableau.varInBaseCol[i] < tableau.varInBaseCol[row])) {
+                    min = ratio;
+                    row = i;
+                }
+            }
+        }
+        if (row < 0) {
+            status = DualSolverStatus::PRIMAL_UNBOUNDED;
+            return false;
+        }
+
+        doDualPivot(row, col);
+        iterations++;
+    }
 }
 
 DualSolver::~DualSolver(void) {
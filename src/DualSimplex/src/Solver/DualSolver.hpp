@@ -3,21 +3,175 @@
 
 #include "Tableau.hpp"
 #include "TableauFilesManager.hpp"
+#include <Eigen/LU>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <set>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+enum class DualSolverStatus { OPTIMAL, PRIMAL_INFEASIBLE, PRIMAL_UNBOUNDED, ITERATION_LIMIT, TIME_LIMIT, CANCELLED };
+
+const char *getStatusName(const DualSolverStatus status);
+
+// Leaving row among the ones with negative known term
+//  BLAND -> the one with the lowest variable in base (Bland dual rule, no cycling)
+//  DANTZIG -> the one with the most negative known term
+//  RANDOM -> a random one (seeded)
+enum class RowSelectionRule { BLAND, DANTZIG, RANDOM };
+
+// Can be cancelled from any thread (or signal handler), the solver stops at the next iteration
+class CancellationToken {
+
+public:
+    void cancel(void) { cancelled.store(true, std::memory_order_relaxed); }
+    void reset(void) { cancelled.store(false, std::memory_order_relaxed); }
+    bool isCancelled(void) const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled{false};
+
+};
+
+typedef struct DualSolverProgress {
+    unsigned long iteration;
+    // Objective function value (not negated)
+    Eigen::dcomplex objFunc;
+    // Sum of the negative known terms (absolute value)
+    Eigen::dcomplex primalInfeasibility;
+} DualSolverProgress;
+
+typedef struct DualSolverOptions {
+    RowSelectionRule rowSelectionRule = RowSelectionRule::BLAND;
+    unsigned int seed = 0;
+
+    // Pivots on a single precision copy of the coefficients matrix, refined in double precision
+    // periodically and at the end (falls back to double precision if it drifts too much)
+    bool mixedPrecision = false;
+    OutputFormat outputFormat = OutputFormat::TABLEAU;
+
+    // Perturbs costs before the iterations against degeneracy (removed at the end)
+    bool perturbCosts = false;
+
+    // The pivot updates only the columns with a nonzero coefficient in the pivot row, when they are few
+    bool sparsePivot = false;
+
+    // The leaving row is chosen among few candidate infeasible rows, refreshed by a full scan only periodically
+    bool partialPricing = false;
+
+    // Limits of the iterations of the Dual Simplex, 0 means no limit
+    unsigned long maxIterations = 0;
+    double timeLimitSeconds = 0.0;
+    // Not owned, it must outlive the solver
+    CancellationToken *cancellationToken = nullptr;
+    // Writes the last tableau (or solution) if iterations are interrupted by a limit or a cancellation
+    bool printInterrupted = true;
+
+    // Called every progressPeriod iterations (0 is taken as 1)
+    std::function<void(const DualSolverProgress&)> progressCallback;
+    unsigned long progressPeriod = 100;
+} DualSolverOptions;
 
 class DualSolver {
 
 public:
-    DualSolver(const char *filePath);
-    void startDualSimplex(void);
+    DualSolver(const char *filePath, const DualSolverOptions& options = DualSolverOptions());
+    // Copy of an already loaded solver (not started yet) that writes in outFolderPath continuing its files numbering
+    DualSolver(const DualSolver& loaded, const DualSolverOptions& options, const std::string& outFolderPath);
+    // Solver without files, problems are loaded from streams one after the other with loadTableau
+    DualSolver(const DualSolverOptions& options);
+    // Reads the next .dat problem from fin, it can be solved only if READ is returned
+    TableauReadStatus loadTableau(FILE *fin);
+    // The problem can be solved only if it has been read (files with a malformed problem are refused)
+    bool isLoaded(void) const { return readStatus == TableauReadStatus::READ; }
+    DualSolverStatus startDualSimplex(void);
+    TableauFilesManager *getTableauFilesManager(void) { return tableauInOut; }
     ~DualSolver(void);
 
 private:
     TableauFilesManager *tableauInOut;
     Tableau tableau;
+    TableauReadStatus readStatus = TableauReadStatus::END;
+    DualSolverOptions options;
+    // Work matrix of deleteDependentRows, kept so that the next problems reuse it (stream solvers only)
+    Eigen::MatrixXd equationsStorage;
+    bool reuseStorage = false;
+
+    // Key of a row in infeasibleRows as (rule values..., variable in base, row)
+    typedef std::tuple<double, double, Eigen::Index, Eigen::Index> InfeasibleRowKey;
+
+    // Rows with negative known term, the first one is the leaving row by the row selection rule
+    std::set<InfeasibleRowKey> infeasibleRows;
+    // Key with which each row is in infeasibleRows, the row is -1 if it is not
+    std::vector<InfeasibleRowKey> infeasibleRowsKeys;
+    // infeasibleRows is updated by pivots only once it has been initialized
+    bool trackInfeasibleRows = false;
+
+    // Partial pricing: best infeasible rows of the last full scan, reused by the next iterations
+    std::vector<Eigen::Index> pricingCandidates;
+    // Work vector of the full scan, kept so that the next scans reuse it
+    std::vector<InfeasibleRowKey> pricingKeys;
+    unsigned long pivotsSincePricing = 0;
 
+    // While true only coeffMatrixSingle is up to date, tableau.coeffStorage is kept only as destination of the refinements
+    bool singlePrecision = false;
+    Eigen::MatrixXf coeffMatrixSingle;
+    // Tableau from which the current one is recomputed in double precision
+    Tableau refinementTableau;
+    // Base matrix and its factorization, allocated once for all the refinements
+    Eigen::MatrixXd refinementBase;
+    Eigen::PartialPivLU<Eigen::MatrixXd> refinementLu;
+    // Base of the last refinement, restored if the single precision pivots make the base singular
+    Eigen::ArrayXindex refinedBaseCol;
+    unsigned long pivotsSinceRefinement = 0;
+    unsigned long refinementPeriod = 0;
+
+    std::mt19937 randomGenerator;
+
+    // Amount added to the cost of each variable by perturbation and shifting
+    Eigen::ArrayXd costPerturbation;
+    // Scale of the perturbation of each column (its magnitude times COST_PERTURBATION_BASE)
+    Eigen::ArrayXd perturbationScale;
+    bool costsPerturbed = false;
+
+    // Columns with a nonzero coefficient in the row of the last ratio test (sparse pivot only), empty if it found no column
+    std::vector<Eigen::Index> pivotRowColumns;
+
+    unsigned long iterations = 0;
+    std::chrono::steady_clock::time_point startTime;
+
+    void setOptions(const DualSolverOptions& options);
+    void deleteDependentRows(void);
+    bool isInterrupted(DualSolverStatus& status);
+    void notifyProgress(void);
     bool doDualCostsValidation(void);
-    void doDualPivot(const Eigen::Index r, const Eigen::Index c);
+    // rowColumns: columns with a nonzero coefficient in row r (from the ratio test), if given only them are updated
+    void doDualPivot(const Eigen::Index r, const Eigen::Index c, const std::vector<Eigen::Index> *rowColumns = nullptr);
+    Eigen::Index doDualRatioTest(const Eigen::Index r);
+    void initInfeasibleRows(void);
+    void updateInfeasibleRow(const Eigen::Index i);
+    InfeasibleRowKey getInfeasibleRowKey(const Eigen::Index i);
+    void refreshPricingCandidates(void);
+    Eigen::Index selectLeavingRow(void);
+    void startCostPerturbation(void);
+    void doCostShifting(void);
+    void removeCostPerturbation(void);
+    bool doPrimalCleanup(DualSolverStatus& status);
+    void startMixedPrecision(void);
+    bool doMixedPrecisionRefinement(const bool last);
+
+    template<typename Matrix>
+    void doDualPivot(Matrix& coeffMatrix, const Eigen::Index r, const Eigen::Index c,
+                     const std::vector<Eigen::Index> *rowColumns);
+    template<typename Matrix>
+    void doDualPivotSparse(Matrix& coeffMatrix, const Eigen::Index r, const Eigen::Index c,
+                           const std::vector<Eigen::Index>& rowColumns);
+    template<typename Matrix>
+    Eigen::Index doDualRatioTest(const Matrix& coeffMatrix, const Eigen::Index r, const double tolerance);
 };
 
 #endif // __DUAL_SOLVER__HPP
@@ -0,0 +1,83 @@
+#include "RaceSolver.hpp"
+#include "utils.hpp"
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+RaceSolver::RaceSolver(const char *filePath, const vector<DualSolverOptions>& configurations) {
+    assert(!configurations.empty());
+    loaded = new DualSolver(filePath, configurations[0]);
+    this->configurations = configurations;
+}
+
+static bool isVerdict(const DualSolverStatus status) {
+    return status == DualSolverStatus::OPTIMAL
+        || status == DualSolverStatus::PRIMAL_INFEASIBLE
+        || status == DualSolverStatus::PRIMAL_UNBOUNDED;
+}
+
+DualSolverStatus RaceSolver::startRace(void) {
+    const size_t count = configurations.size();
+    const string outFolderPath = loaded->getTableauFilesManager()->getOutFolderPath();
+    // The external token (if any) is forwarded to the race one by this thread
+    CancellationToken *externalToken = configurations[0].cancellationToken;
+    CancellationToken raceToken;
+
+    vector<DualSolver *> solvers(count);
+    vector<DualSolverStatus> statuses(count, DualSolverStatus::CANCELLED);
+    for (size_t k = 0; k < count; k++) {
+        DualSolverOptions options = configurations[k];
+        options.cancellationToken = &raceToken;
+        options.printInterrupted = true;
+        solvers[k] = new DualSolver(*loaded, options, outFolderPath + "/" + FILES_OUT_RACE_PREFIX + to_string(k + 1));
+    }
+
+    atomic<long> winner(-1);
+    atomic<size_t> finished(0);
+    vector<thread> threads;
+    for (size_t k = 0; k < count; k++) {
+        threads.emplace_back([&, k]() {
+            statuses[k] = solvers[k]->startDualSimplex();
+            long none = -1;
+            if (isVerdict(statuses[k]) && winner.compare_exchange_strong(none, static_cast<long>(k))) {
+                raceToken.cancel();
+            }
+            finished++;
+        });
+    }
+
+    while (finished < count) {
+        if (externalToken != nullptr && externalToken->isCancelled()) {
+            raceToken.cancel();
+        }
+        this_thread::sleep_for(chrono::milliseconds(RACE_POLL_MILLISECONDS));
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    // Without a verdict (every configuration reached a limit) the first configuration is kept
+    const size_t kept = winner >= 0 ? static_cast<size_t>(winner) : 0;
+    for (size_t k = 0; k < count; k++) {
+        const string racePath = solvers[k]->getTableauFilesManager()->getOutFolderPath();
+        delete solvers[k];
+        if (k == kept) {
+            for (const auto& entry : fs::directory_iterator(racePath)) {
+                fs::rename(entry.path(), fs::path(outFolderPath) / entry.path().filename());
+            }
+        }
+        fs::remove_all(racePath);
+    }
+
+    return statuses[kept];
+}
+
+RaceSolver::~RaceSolver(void) {
+    delete loaded;
+}
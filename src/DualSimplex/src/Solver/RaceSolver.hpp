@@ -0,0 +1,26 @@
+#ifndef __RACE_SOLVER__HPP
+#define __RACE_SOLVER__HPP
+
+#include "DualSolver.hpp"
+#include <vector>
+
+/*
+ * Solves the same problem with different configurations of DualSolver (row selection rule, seed, precision, ...),
+ * each in its own thread. The first one that reaches a verdict cancels the others and only its files are kept.
+ */
+class RaceSolver {
+
+public:
+    // The problem is read (and its dependent rows deleted) only once, with the options of the first configuration
+    RaceSolver(const char *filePath, const std::vector<DualSolverOptions>& configurations);
+    bool isLoaded(void) const { return loaded->isLoaded(); }
+    DualSolverStatus startRace(void);
+    ~RaceSolver(void);
+
+private:
+    DualSolver *loaded;
+    std::vector<DualSolverOptions> configurations;
+
+};
+
+#endif // __RACE_SOLVER__HPP
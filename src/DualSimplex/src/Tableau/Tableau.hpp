@@ -2,6 +2,12 @@
 #define __TABLEAU__HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <vector>
+
+// Spare capacity of the coefficients matrix reserved at load time (for the artificial constraint)
+#define TABLEAU_SPARE_ROWS 1
+#define TABLEAU_SPARE_COLS 1
 
 namespace Eigen {
     typedef Eigen::Array<Eigen::Index, Eigen::Dynamic, 1> ArrayXindex;
@@ -15,12 +21,104 @@ typedef struct Tableau {
     Eigen::ArrayXcd knownTermsCol;
     // Row that contains variables reduced costs
     Eigen::ArrayXd redCostsRow;
-    // Matrix of coefficients
-    Eigen::MatrixXd coeffMatrix;
+    // Storage of the matrix of coefficients, it can have spare rows and columns (always null)
+    // so that the tableau can grow without reallocating and copying it
+    Eigen::MatrixXd coeffStorage;
 
     // Column in base for each row
     Eigen::ArrayXindex varInBaseCol;
 
+    // State of isDualFeasible kept up to date while the tableau changes, so that it is never computed again:
+    // number of negative reduced costs (see setRedCost and countNegativeCosts)
+    Eigen::Index negativeCosts = 0;
+    // number of rows without a valid variable in base (see setInBase and checkBase)
+    Eigen::Index invalidBaseRows = 0;
+
+    // Sets a reduced cost keeping the count of the negative ones
+    void setRedCost(const Eigen::Index j, const double value) {
+        negativeCosts += (value < 0.0) - (redCostsRow[j] < 0.0);
+        redCostsRow[j] = value;
+    }
+
+    // Counts again the negative reduced costs, after redCostsRow is changed as a whole
+    void countNegativeCosts(void) {
+        negativeCosts = (redCostsRow < 0.0).count();
+    }
+
+    // Sets the variable in base of row i (1-based, 0 for none), the variable must be out of base (as in a pivot)
+    void setInBase(const Eigen::Index i, const Eigen::Index var) {
+        invalidBaseRows += (var == 0) - (varInBaseCol[i] == 0);
+        varInBaseCol[i] = var;
+    }
+
+    // Checks again the whole base and the costs, after the tableau is read or its rows change
+    void checkDualFeasibility(void) {
+        countNegativeCosts();
+        checkBase();
+    }
+
+    // Matrix of coefficients (top left getM() x getN() block of the storage)
+    Eigen::Block<Eigen::MatrixXd> coeffMatrix(void) {
+        return coeffStorage.topLeftCorner(getM(), getN());
+    }
+
+    // Makes the matrix of coefficients a null m x n one with its spare capacity,
+    // the storage is reallocated only if it is smaller than that (so it is reused by the next problems)
+    // and only the used block is cleared, so a small problem doesn't pay for the largest one seen
+    void resetCoeffMatrix(const Eigen::Index m, const Eigen::Index n) {
+        if (coeffStorage.rows() < m + TABLEAU_SPARE_ROWS || coeffStorage.cols() < n + TABLEAU_SPARE_COLS) {
+            coeffStorage.resize(std::max(coeffStorage.rows(), m + TABLEAU_SPARE_ROWS),
+                                std::max(coeffStorage.cols(), n + TABLEAU_SPARE_COLS));
+        }
+        coeffStorage.topLeftCorner(m + TABLEAU_SPARE_ROWS, n + TABLEAU_SPARE_COLS).setZero();
+    }
+
+    // Adds a null row and a null column, the storage is reallocated only if there is no spare capacity left
+    void addRowAndCol(void) {
+        const Eigen::Index m = getM();
+        const Eigen::Index n = getN();
+        if (coeffStorage.rows() <= m || coeffStorage.cols() <= n) {
+            coeffStorage.conservativeResize(std::max(coeffStorage.rows(), m + 1), std::max(coeffStorage.cols(), n + 1));
+        }
+        // Spare capacity past the cleared block can hold values of a previous problem
+        coeffStorage.row(m).head(n + 1).setZero();
+        coeffStorage.col(n).head(m + 1).setZero();
+
+        knownTermsCol.conservativeResize(m + 1);
+        knownTermsCol[m] = 0.0;
+        redCostsRow.conservativeResize(n + 1);
+        redCostsRow[n] = 0.0;
+        varInBaseCol.conservativeResize(m + 1);
+        varInBaseCol[m] = 0;
+        invalidBaseRows++;
+    }
+
+    // Deletes the rows with the given (increasing) indices moving the following ones up in place
+    void deleteRows(const std::vector<Eigen::Index>& rows) {
+        const Eigen::Index m = getM();
+        const Eigen::Index n = getN();
+        Eigen::Index newM = 0;
+        size_t k = 0;
+        for (Eigen::Index i = 0; i < m; i++) {
+            if (k < rows.size() && rows[k] == i) {
+                k++;
+                continue;
+            }
+            if (newM != i) {
+                coeffStorage.row(newM).head(n) = coeffStorage.row(i).head(n);
+                knownTermsCol[newM] = knownTermsCol[i];
+                varInBaseCol[newM] = varInBaseCol[i];
+            }
+            newM++;
+        }
+
+        // Freed rows become spare capacity
+        coeffStorage.block(newM, 0, m - newM, n).setZero();
+        knownTermsCol.conservativeResize(newM);
+        varInBaseCol.conservativeResize(newM);
+        checkBase();
+    }
+
     // Number of equations
     Eigen::Index getM(void) {
         return knownTermsCol.size();
@@ -40,8 +138,8 @@ typedef struct Tableau {
     }
 
     bool isValid(void) {
-        return coeffMatrix.rows() == getM() // Coefficient matrix number of rows
-            && coeffMatrix.cols() == getN() // Coefficient matrix number of columns
+        return coeffStorage.rows() >= getM() // Coefficient matrix number of rows
+            && coeffStorage.cols() >= getN() // Coefficient matrix number of columns
             && redCostsRow.size() == getN() // Reduced costs row size
             && knownTermsCol.size() == getM() // Known terms column size
             && varInBaseCol.size() == getM(); // Variables in base column size
@@ -52,26 +150,21 @@ typedef struct Tableau {
     }
 
     bool isDualFeasible(void) {
-        if (!isFeasible()) {
-            return false;
-        }
-
-        // Reduced costs are positive or zero
-        if ((redCostsRow < 0.0).any()) {
-            return false;
-        }
+        return isFeasible() && negativeCosts == 0 && invalidBaseRows == 0;
+    }
 
-        // The tableau has a valid base (with different variables each)
-        Eigen::ArrayXb isInBase = Eigen::ArrayXb::Constant(getN(), false);
+private:
+    // Counts the rows whose variable in base is missing, out of range or already in base in a previous row
+    void checkBase(void) {
+        invalidBaseRows = 0;
+        std::vector<bool> isInBase(getN(), false);
         for (Eigen::Index i = 0; i < getM(); i++) {
-            if ((varInBaseCol[i] <= 0) || (varInBaseCol[i] >= getCols())) {
-                return false;
+            if ((varInBaseCol[i] <= 0) || (varInBaseCol[i] >= getCols()) || isInBase[varInBaseCol[i] - 1]) {
+                invalidBaseRows++;
             } else {
                 isInBase[varInBaseCol[i] - 1] = true;
             }
         }
-
-        return (isInBase == true).count() == getM();
     }
 
 } Tableau;
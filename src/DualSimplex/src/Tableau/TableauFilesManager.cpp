@@ -1,22 +1,29 @@
 #include "TableauFilesManager.hpp"
 #include "utils.hpp"
 #include <assert.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <filesystem>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
 namespace fs = std::filesystem;
 
-TableauFilesManager::TableauFilesManager(Tableau *const tableau, const char *filePath) {
+TableauFilesManager::TableauFilesManager(Tableau *const tableau, const char *filePath, const OutputFormat outputFormat) {
     assert(tableau != NULL && filePath != NULL);
 
     const string outFolderName = getFileNameWithoutExtension(filePath);
     stringstream ss;
     ss << FILES_OUT_PATH << outFolderName;
     string folderPath = ss.str();
+    outFolderPath = folderPath;
     ss << "/" << FILES_OUT_PREFIX;
     outPartialFilePath = ss.str();
     fs::path outDirectory = fs::path(outPartialFilePath);
@@ -30,19 +37,90 @@ TableauFilesManager::TableauFilesManager(Tableau *const tableau, const char *fil
 
     this->inFilePath = filePath;
     this->tableau = tableau;
+    this->outputFormat = outputFormat;
+}
+
+TableauFilesManager::TableauFilesManager(Tableau *const tableau, const TableauFilesManager& other, const string& outFolderPath,
+                                         const OutputFormat outputFormat) {
+    assert(tableau != NULL);
+
+    this->outFolderPath = outFolderPath;
+    outPartialFilePath = outFolderPath + "/" + FILES_OUT_PREFIX;
+    if (!fs::exists(outFolderPath) && !fs::create_directories(outFolderPath)) {
+        std::cerr << "Failed to create " << outFolderPath << " directory." << std::endl;
+    }
+
+    this->inFilePath = other.inFilePath;
+    this->counter = other.counter;
+    this->tableau = tableau;
+    this->outputFormat = outputFormat;
+}
+
+TableauFilesManager::TableauFilesManager(Tableau *const tableau) {
+    assert(tableau != NULL);
+
+    this->inFilePath = NULL;
+    this->tableau = tableau;
+    this->outputFormat = OutputFormat::NONE;
 }
 
 const string TableauFilesManager::getNextFilename(void) {
     return outPartialFilePath + to_string(counter++) + FILES_OUT_EXTENSION;
 }
 
-void TableauFilesManager::readTableau(void) {
-    FILE *fin = fopen(inFilePath, "r");
-    assert(fin != NULL);
+TableauReadStatus TableauFilesManager::readTableau(void) {
+    string extension = fs::path(inFilePath).extension().string();
+    transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return tolower(c); });
 
+    tableau->objFunc = 0.0;
+    TableauReadStatus read;
+    if (extension == FILES_IN_MPS_EXTENSION) {
+        read = readMpsTableau();
+    } else {
+        FILE *fin = fopen(inFilePath, "r");
+        assert(fin != NULL);
+        read = readDatTableau(fin);
+        const int closed = fclose(fin);
+        assert(closed == 0);
+        (void) closed;
+        if (read != TableauReadStatus::READ) {
+            cerr << "File '" << inFilePath << "' refused: malformed or truncated problem." << endl;
+        }
+    }
+    if (read != TableauReadStatus::READ) {
+        return TableauReadStatus::MALFORMED;
+    }
+    tableau->checkDualFeasibility();
+
+    printTableau("Tableau represented as read.\n"
+    "The first row contains the objective function negate and reduced costs.\n"
+    "The first column contains the known terms.\n"
+    "x1..n are the decision variables.", "AS READ");
+    return TableauReadStatus::READ;
+}
+
+TableauReadStatus TableauFilesManager::readTableau(FILE *fin) {
+    tableau->objFunc = 0.0;
+    const TableauReadStatus read = readDatTableau(fin);
+    if (read == TableauReadStatus::READ) {
+        tableau->checkDualFeasibility();
+    }
+    return read;
+}
+
+/*
+ * Reads exactly one problem from fin, so problems can be read one after the other from the same stream.
+ * Every value is checked, a malformed or truncated problem is reported (the tableau is left incomplete).
+ */
+TableauReadStatus TableauFilesManager::readDatTableau(FILE *fin) {
     // READ number of rows and columns
     unsigned long m, n;
-    assert(fscanf(fin, "%lu %lu", &n, &m) > 0);
+    const int sizes = fscanf(fin, "%lu %lu", &n, &m);
+    if (sizes == EOF) {
+        return TableauReadStatus::END;
+    } else if (sizes != 2) {
+        return TableauReadStatus::MALFORMED;
+    }
     // It's not important to check here m <= n because there could be linear dependence between equations
     // This check will be done later on
 
@@ -56,7 +134,9 @@ void TableauFilesManager::readTableau(void) {
     // READ known terms column
     for (unsigned long i = 0; i < m; i++) {
         double di;
-        assert(fscanf(fin, "%lf", &(di)) > 0);
+        if (fscanf(fin, "%lf", &(di)) != 1) {
+            return TableauReadStatus::MALFORMED;
+        }
         tableau->knownTermsCol[i] = di;
     }
 
@@ -65,10 +145,10 @@ void TableauFilesManager::readTableau(void) {
 
     // READ slack or surplus vector
     for (unsigned long i = 0; i < m; i++) {
-        assert(fscanf(fin, "%lf", &(slackOrSurplus[i])) > 0);
-        assert(slackOrSurplus[i] == 0.0
-            || slackOrSurplus[i] == 1.0
-            || slackOrSurplus[i] == -1.0);
+        if (fscanf(fin, "%lf", &(slackOrSurplus[i])) != 1
+                || (slackOrSurplus[i] != 0.0 && slackOrSurplus[i] != 1.0 && slackOrSurplus[i] != -1.0)) {
+            return TableauReadStatus::MALFORMED;
+        }
 
         if (slackOrSurplus[i] != 0.0) {
             artificialCount++;
@@ -76,16 +156,18 @@ void TableauFilesManager::readTableau(void) {
     }
 
     unsigned long na = n + artificialCount;
-    tableau->coeffMatrix = Eigen::MatrixXd::Zero(m, na);
-
     tableau->redCostsRow = Eigen::ArrayXd::Zero(na);
+    tableau->resetCoeffMatrix(m, na);
+
     // READ the coefficients matrix A
     for (unsigned long j = 0; j < n; j++) {
         bool inBase = true;
 
         // READ column reduced cost
         double cc;
-        assert(fscanf(fin, "%lf", &cc) > 0);
+        if (fscanf(fin, "%lf", &cc) != 1) {
+            return TableauReadStatus::MALFORMED;
+        }
         if (cc != 0.0) {
             inBase = false;
         }
@@ -93,48 +175,399 @@ void TableauFilesManager::readTableau(void) {
 
         // READ number of non zeros coefficients
         unsigned long not0;
-        assert(fscanf(fin, "%lu", &not0) > 0);
+        if (fscanf(fin, "%lu", &not0) != 1 || not0 > m) {
+            return TableauReadStatus::MALFORMED;
+        }
         if (inBase && not0 != 1) {
             inBase = false;
         }
 
         // READ non zeros coefficients
-        unsigned long rr;
+        unsigned long rr = 0;
         for (unsigned long k = 0; k < not0; k++) {
-            assert(fscanf(fin, "%lu", &rr) > 0);
-            assert(fscanf(fin, "%lf", &(tableau->coeffMatrix(rr - 1, j))) > 0);
+            if (fscanf(fin, "%lu", &rr) != 1 || rr < 1 || rr > m
+                    || fscanf(fin, "%lf", &(tableau->coeffMatrix()(rr - 1, j))) != 1) {
+                return TableauReadStatus::MALFORMED;
+            }
         }
-        if (inBase && (tableau->coeffMatrix(rr - 1, j) == 1.0)) {
+        if (inBase && (tableau->coeffMatrix()(rr - 1, j) == 1.0)) {
             tableau->varInBaseCol[rr - 1] = j + 1;
         }
     }
 
-    // Fill with slacks and surplus (artificial variables)
+    addSlackOrSurplus(slackOrSurplus, n);
+    return TableauReadStatus::READ;
+}
+
+// MPS sections, in the order in which they can appear in the file
+enum class MpsSection { NONE, NAME, OBJSENSE, ROWS, COLUMNS, RHS, RANGES, BOUNDS, END };
+
+// Row added to the constraints read from ROWS section to express ranges and bounds
+typedef struct MpsExtraRow {
+    // 'L', 'G' or 'E' as in ROWS section
+    char sense;
+    // Row whose coefficients are copied (range), -1 if it is a bound of a single column
+    Eigen::Index sourceRow;
+    // Bounded column, used only if sourceRow is -1
+    Eigen::Index sourceCol;
+    double rhs;
+} MpsExtraRow;
+
+static MpsSection getMpsSection(const string& keyword) {
+    if (keyword == "NAME") return MpsSection::NAME;
+    if (keyword == "OBJSENSE") return MpsSection::OBJSENSE;
+    if (keyword == "ROWS") return MpsSection::ROWS;
+    if (keyword == "COLUMNS") return MpsSection::COLUMNS;
+    if (keyword == "RHS") return MpsSection::RHS;
+    if (keyword == "RANGES") return MpsSection::RANGES;
+    if (keyword == "BOUNDS") return MpsSection::BOUNDS;
+    if (keyword == "ENDATA") return MpsSection::END;
+    return MpsSection::NONE;
+}
+
+// Returns false if token is not entirely a finite number
+static bool parseMpsNumber(const string& token, double& value) {
+    char *end;
+    value = strtod(token.c_str(), &end);
+    return end != token.c_str() && *end == '\0' && isfinite(value);
+}
+
+static TableauReadStatus refuseMps(const char *filePath, const string& line, const string& reason) {
+    cerr << "MPS file '" << filePath << "' refused: " << reason;
+    if (!line.empty()) {
+        cerr << " in line '" << line << "'";
+    }
+    cerr << "." << endl;
+    return TableauReadStatus::MALFORMED;
+}
+
+/*
+ * Reads fixed or free MPS in a single pass: fields are separated by white spaces (so names can not contain spaces).
+ * Only the nonzero coefficients are kept while the file is streamed, the dense Tableau is built at the end.
+ * Every variable is assumed >= 0, as in .dat files: upper, fixed and positive lower bounds become constraints, while
+ * free or negative bounds are not supported. Files with unsupported bounds or malformed lines are refused (MALFORMED).
+ */
+TableauReadStatus TableauFilesManager::readMpsTableau(void) {
+    ifstream fin(inFilePath);
+    if (!fin.is_open()) {
+        return refuseMps(inFilePath, "", "it can not be opened");
+    }
+
+    unordered_map<string, Eigen::Index> rowsIndices;
+    unordered_map<string, Eigen::Index> colsIndices;
+    string objectiveRowName;
+    vector<char> rowsSense;
+    vector<double> rowsRhs;
+    vector<double> rowsRange;
+    vector<bool> rowsHasRange;
+    vector<MpsExtraRow> extraRows;
+
+    vector<double> costs;
+    // Nonzero coefficients of the constraints in (row, column, value) format
+    vector<Eigen::Index> entriesRow;
+    vector<Eigen::Index> entriesCol;
+    vector<double> entriesValue;
+
+    bool maximize = false;
+    double objectiveRhs = 0.0;
+
+    MpsSection section = MpsSection::NONE;
+    string line;
+    vector<string> tokens;
+    while (section != MpsSection::END && getline(fin, line)) {
+        if (line.empty() || line[0] == '*') {
+            continue;
+        }
+
+        tokens.clear();
+        istringstream ss(line);
+        string token;
+        while (ss >> token) {
+            tokens.push_back(token);
+        }
+        if (tokens.empty()) {
+            continue;
+        }
+
+        // Section keywords start in the first column, data lines usually do not
+        if (!isspace(static_cast<unsigned char>(line[0]))) {
+            const MpsSection next = getMpsSection(tokens[0]);
+            if (next != MpsSection::NONE) {
+                section = next;
+                // Free MPS allows OBJSENSE value on the same line of the keyword
+                if (section == MpsSection::OBJSENSE && tokens.size() > 1) {
+                    maximize = tokens[1] == "MAX" || tokens[1] == "MAXIMIZE";
+                }
+                continue;
+            }
+        }
+
+        switch (section) {
+            case MpsSection::OBJSENSE:
+                maximize = tokens[0] == "MAX" || tokens[0] == "MAXIMIZE";
+                break;
+
+            case MpsSection::ROWS: {
+                const char sense = toupper(tokens[0][0]);
+                if (tokens.size() != 2 || tokens[0].size() != 1) {
+                    return refuseMps(inFilePath, line, "row definition not as 'type name'");
+                } else if (sense == 'N') {
+                    // Only the first free row is the objective function, the others are ignored
+                    if (objectiveRowName.empty()) {
+                        objectiveRowName = tokens[1];
+                    }
+                } else if (sense != 'L' && sense != 'G' && sense != 'E') {
+                    return refuseMps(inFilePath, line, "unknown row type");
+                } else {
+                    rowsIndices[tokens[1]] = rowsSense.size();
+                    rowsSense.push_back(sense);
+                    rowsRhs.push_back(0.0);
+                    rowsRange.push_back(0.0);
+                    rowsHasRange.push_back(false);
+                }
+                break;
+            }
+
+            case MpsSection::COLUMNS: {
+                // Integrality markers are ignored, the problem is solved as continuous
+                if (tokens.size() > 1 && tokens[1] == "'MARKER'") {
+                    break;
+                }
+                if (tokens.size() != 3 && tokens.size() != 5) {
+                    return refuseMps(inFilePath, line, "column entry not as 'column row value [row value]'");
+                }
+
+                Eigen::Index j;
+                const auto col = colsIndices.find(tokens[0]);
+                if (col == colsIndices.end()) {
+                    j = costs.size();
+                    colsIndices[tokens[0]] = j;
+                    costs.push_back(0.0);
+                } else {
+                    j = col->second;
+                }
+
+                for (size_t k = 1; k + 1 < tokens.size(); k += 2) {
+                    double value;
+                    if (!parseMpsNumber(tokens[k + 1], value)) {
+                        return refuseMps(inFilePath, line, "invalid number '" + tokens[k + 1] + "'");
+                    }
+                    if (tokens[k] == objectiveRowName) {
+                        costs[j] += value;
+                    } else {
+                        const auto row = rowsIndices.find(tokens[k]);
+                        // Rows not found are free rows (not the objective function)
+                        if (row != rowsIndices.end() && value != 0.0) {
+                            entriesRow.push_back(row->second);
+                            entriesCol.push_back(j);
+                            entriesValue.push_back(value);
+                        }
+                    }
+                }
+                break;
+            }
+
+            case MpsSection::RHS:
+            case MpsSection::RANGES: {
+                // The set name is optional
+                if (tokens.size() < 2 || tokens.size() > 5) {
+                    return refuseMps(inFilePath, line, "entry not as '[set] row value [row value]'");
+                }
+                const size_t first = (tokens.size() % 2 == 0) ? 0 : 1;
+
+                for (size_t k = first; k + 1 < tokens.size(); k += 2) {
+                    double value;
+                    if (!parseMpsNumber(tokens[k + 1], value)) {
+                        return refuseMps(inFilePath, line, "invalid number '" + tokens[k + 1] + "'");
+                    }
+                    if (section == MpsSection::RHS && tokens[k] == objectiveRowName) {
+                        objectiveRhs = value;
+                        continue;
+                    }
+                    const auto row = rowsIndices.find(tokens[k]);
+                    if (row == rowsIndices.end()) {
+                        continue;
+                    }
+                    if (section == MpsSection::RHS) {
+                        rowsRhs[row->second] = value;
+                    } else {
+                        rowsRange[row->second] = value;
+                        rowsHasRange[row->second] = true;
+                    }
+                }
+                break;
+            }
+
+            case MpsSection::BOUNDS: {
+                // Format: type [set name] column [value]
+                const string& type = tokens[0];
+                if (type == "FR" || type == "MI") {
+                    return refuseMps(inFilePath, line, "unsupported bound " + type + " (variables must be >= 0)");
+                }
+                const bool hasValue = !(type == "PL" || type == "BV");
+                if (tokens.size() < (hasValue ? 3u : 2u) || tokens.size() > (hasValue ? 4u : 3u)) {
+                    return refuseMps(inFilePath, line, "bound not as 'type [set] column" + string(hasValue ? " value'" : "'"));
+                }
+                const size_t colPos = tokens.size() - (hasValue ? 2 : 1);
+                const auto col = colsIndices.find(tokens[colPos]);
+                if (col == colsIndices.end()) {
+                    return refuseMps(inFilePath, line, "unknown column '" + tokens[colPos] + "'");
+                }
+                const Eigen::Index j = col->second;
+                double value = 0.0;
+                if (hasValue && !parseMpsNumber(tokens[colPos + 1], value)) {
+                    return refuseMps(inFilePath, line, "invalid number '" + tokens[colPos + 1] + "'");
+                }
+                if (hasValue && value < 0.0) {
+                    return refuseMps(inFilePath, line, "unsupported negative bound (variables must be >= 0)");
+                }
+
+                if (type == "UP" || type == "UI") {
+                    extraRows.push_back({'L', -1, j, value});
+                } else if (type == "BV") {
+                    extraRows.push_back({'L', -1, j, 1.0});
+                } else if (type == "LO" || type == "LI") {
+                    if (value > 0.0) {
+                        extraRows.push_back({'G', -1, j, value});
+                    }
+                } else if (type == "FX") {
+                    extraRows.push_back({'E', -1, j, value});
+                } else if (type != "PL") {
+                    return refuseMps(inFilePath, line, "unknown bound type " + type);
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+    fin.close();
+
+    // A range R on a row means: L -> [rhs - |R|, rhs], G -> [rhs, rhs + |R|],
+    // E -> [rhs, rhs + R] if R > 0 else [rhs + R, rhs]
+    for (size_t i = 0; i < rowsSense.size(); i++) {
+        if (!rowsHasRange[i]) {
+            continue;
+        }
+        const double range = rowsRange[i];
+        switch (rowsSense[i]) {
+            case 'L':
+                extraRows.push_back({'G', static_cast<Eigen::Index>(i), -1, rowsRhs[i] - abs(range)});
+                break;
+            case 'G':
+                extraRows.push_back({'L', static_cast<Eigen::Index>(i), -1, rowsRhs[i] + abs(range)});
+                break;
+            default:
+                if (range >= 0.0) {
+                    rowsSense[i] = 'G';
+                    extraRows.push_back({'L', static_cast<Eigen::Index>(i), -1, rowsRhs[i] + range});
+                } else {
+                    rowsSense[i] = 'L';
+                    extraRows.push_back({'G', static_cast<Eigen::Index>(i), -1, rowsRhs[i] + range});
+                }
+                break;
+        }
+    }
+
+    const Eigen::Index n = costs.size();
+    const Eigen::Index m = rowsSense.size() + extraRows.size();
+
+    // Slack or surplus terms for each row
+    vector<double> slackOrSurplus(m);
+    Eigen::Index artificialCount = 0;
+
+    tableau->knownTermsCol.resize(m);
+    for (Eigen::Index i = 0; i < m; i++) {
+        char sense;
+        if (i < static_cast<Eigen::Index>(rowsSense.size())) {
+            sense = rowsSense[i];
+            tableau->knownTermsCol[i] = rowsRhs[i];
+        } else {
+            sense = extraRows[i - rowsSense.size()].sense;
+            tableau->knownTermsCol[i] = extraRows[i - rowsSense.size()].rhs;
+        }
+
+        slackOrSurplus[i] = (sense == 'L') ? 1.0 : ((sense == 'G') ? -1.0 : 0.0);
+        if (slackOrSurplus[i] != 0.0) {
+            artificialCount++;
+        }
+    }
+
+    const Eigen::Index na = n + artificialCount;
+    tableau->redCostsRow = Eigen::ArrayXd::Zero(na);
+    tableau->resetCoeffMatrix(m, na);
+    for (size_t k = 0; k < entriesValue.size(); k++) {
+        tableau->coeffMatrix()(entriesRow[k], entriesCol[k]) += entriesValue[k];
+    }
+    for (size_t k = 0; k < extraRows.size(); k++) {
+        const Eigen::Index i = rowsSense.size() + k;
+        if (extraRows[k].sourceRow >= 0) {
+            tableau->coeffMatrix().row(i) = tableau->coeffMatrix().row(extraRows[k].sourceRow);
+        } else {
+            tableau->coeffMatrix()(i, extraRows[k].sourceCol) = 1.0;
+        }
+    }
+
+    for (Eigen::Index j = 0; j < n; j++) {
+        tableau->redCostsRow[j] = maximize ? -costs[j] : costs[j];
+    }
+    tableau->objFunc = maximize ? -objectiveRhs : objectiveRhs;
+
+    // Columns that are already an identity column with null cost are in base
+    tableau->varInBaseCol = Eigen::ArrayXindex::Zero(m);
+    for (Eigen::Index j = 0; j < n; j++) {
+        if (tableau->redCostsRow[j] != 0.0 || (tableau->coeffMatrix().col(j).array() != 0.0).count() != 1) {
+            continue;
+        }
+        Eigen::Index r;
+        tableau->coeffMatrix().col(j).cwiseAbs().maxCoeff(&r);
+        if (tableau->coeffMatrix()(r, j) == 1.0) {
+            tableau->varInBaseCol[r] = j + 1;
+        }
+    }
+
+    addSlackOrSurplus(slackOrSurplus, n);
+    return TableauReadStatus::READ;
+}
+
+// Fills the columns after the n decision variables with slacks and surplus (artificial variables)
+void TableauFilesManager::addSlackOrSurplus(const vector<double>& slackOrSurplus, const Eigen::Index n) {
     Eigen::Index k = 0;
-    for (unsigned long j = n; j < na; j++) {
+    for (Eigen::Index j = n; j < tableau->getN(); j++) {
         while (slackOrSurplus[k] == 0.0) {
             k++;
         }
-        tableau->coeffMatrix(k, j) = slackOrSurplus[k];
+        tableau->coeffMatrix()(k, j) = slackOrSurplus[k];
         if (slackOrSurplus[k] == -1.0) {
-            tableau->coeffMatrix.row(k) *= -1;
+            tableau->coeffMatrix().row(k) *= -1;
             tableau->knownTermsCol[k] *= -1;
         }
         tableau->varInBaseCol[k] = j + 1;
         k++;
     }
+}
 
-    assert(fclose(fin) == 0);
+// Appends to outBuffer the part in common between the full and the short representations
+void TableauFilesManager::appendTableauHeader(const string& caption, const string& description, const string& title) {
+    outBuffer.append(caption).append("\n\n\n");
 
-    printTableau("Tableau represented as read.\n"
-    "The first row contains the objective function negate and reduced costs.\n"
-    "The first column contains the known terms.\n"
-    "x1..n are the decision variables.", "AS READ");
-}
+    if (title != "") {
+        outBuffer.append(title).append("\n\n");
+    }
 
-void TableauFilesManager::printTableauShort(const string& caption, const string& description,
-                                            const string& title, const string& filename) {
+    assert(description != "");
+    outBuffer.append(description).append("\n\n");
+
+    appendPrintf(outBuffer, "Tableau rows x cols: %lu x %lu\n\n", tableau->getRows(), tableau->getCols());
+
+    outBuffer.append("OBJECTIVE FUNCTION VALUE:\n");
+    appendFormattedComplex(outBuffer, -tableau->objFunc);
+    outBuffer.append("\n\n");
+}
 
+// Writes outBuffer with a single write
+void TableauFilesManager::writeOutBuffer(const string& filename) {
     FILE *fout;
     if (filename == "") {
         fout = fopen(getNextFilename().c_str(), "w");
@@ -143,49 +576,53 @@ void TableauFilesManager::printTableauShort(const string& caption, const string&
     }
     assert(fout != NULL);
 
-    assert(fprintf(fout, "%s\n\n\n", caption.c_str()) > 0);
-
-    if (title != "") {
-        assert(fprintf(fout, "%s\n\n", title.c_str()) > 0);
-    }
-
-    assert(description != "");
-    assert(fprintf(fout, "%s", description.c_str()) > 0);
-    assert(fprintf(fout, "\n\n") > 0);
+    const size_t written = fwrite(outBuffer.data(), sizeof(char), outBuffer.size(), fout);
+    assert(written == outBuffer.size());
+    (void) written;
 
-    assert(fprintf(fout, "Tableau rows x cols: %lu x %lu\n\n", tableau->getRows(), tableau->getCols()) > 0);
+    const int closed = fclose(fout);
+    assert(closed == 0);
+    (void) closed;
+}
 
-    assert(fprintf(fout, "OBJECTIVE FUNCTION VALUE:\n") > 0);
-    assert(fprintf(fout, "%s\n\n", getFormattedComplex(-tableau->objFunc).c_str()) > 0);
+void TableauFilesManager::printTableauShort(const string& caption, const string& description,
+                                            const string& title, const string& filename) {
+    outBuffer.clear();
+    appendTableauHeader(caption, description, title);
 
-    assert(fprintf(fout, "OBJECTIVE FUNCTION VALUE (negated):\n") > 0);
-    assert(fprintf(fout, "%s\n\n", getFormattedComplex(tableau->objFunc).c_str()) > 0);
+    outBuffer.append("OBJECTIVE FUNCTION VALUE (negated):\n");
+    appendFormattedComplex(outBuffer, tableau->objFunc);
+    outBuffer.append("\n\n");
 
-    assert(fprintf(fout, "KNOWN TERMS:\n") > 0);
+    outBuffer.append("KNOWN TERMS:\n");
     for (Eigen::Index i = 0; i < tableau->getM(); i++) {
-        assert(fprintf(fout, "%s (x%-5lu -> x%-5lu)  ",
-            getFormattedComplex(tableau->knownTermsCol[i]).c_str(),
-            i + 1,
-            tableau->varInBaseCol[i]) > 0);
+        appendFormattedComplex(outBuffer, tableau->knownTermsCol[i]);
+        appendPrintf(outBuffer, " (x%-5lu -> x%-5lu)  ", i + 1, tableau->varInBaseCol[i]);
         if ((i + 1) % 3 == 0) {
-            assert(fprintf(fout, "\n") > 0);
+            outBuffer.push_back('\n');
         }
     }
-    assert(fprintf(fout, "\n\n") > 0);
+    outBuffer.append("\n\n");
 
-    assert(fprintf(fout, "COSTS:\n") > 0);
+    outBuffer.append("COSTS:\n");
     for (Eigen::Index j = 0; j < tableau->getN(); j++) {
-        assert(fprintf(fout, "%s (x%-5lu)  ", getFormattedDouble(tableau->redCostsRow[j]).c_str(), j + 1) > 0);
+        appendFormattedDouble(outBuffer, tableau->redCostsRow[j]);
+        appendPrintf(outBuffer, " (x%-5lu)  ", j + 1);
         if ((j + 1) % 3 == 0) {
-            assert(fprintf(fout, "\n") > 0);
+            outBuffer.push_back('\n');
         }
     }
-    assert(fprintf(fout, "\n") > 0);
+    outBuffer.push_back('\n');
 
-    assert(fclose(fout) == 0);
+    writeOutBuffer(filename);
 }
 
 void TableauFilesManager::printTableau(const string& description, const string& title, const string& filename) {
+    // Only the solution is written in solution formats
+    if (outputFormat != OutputFormat::TABLEAU) {
+        return;
+    }
+
     string caption;
 #ifdef DEBUG
     assert(tableau->isValid());
@@ -204,60 +641,124 @@ void TableauFilesManager::printTableau(const string& description, const string&
         return;
     }
 
-    FILE *fout;
-    if (filename == "") {
-        fout = fopen(getNextFilename().c_str(), "w");
-    } else {
-        fout = fopen(filename.c_str(), "w");
-    }
-    assert(fout != NULL);
-
-    assert(fprintf(fout, "%s\n\n\n", caption.c_str()) > 0);
-
-    if (title != "") {
-        assert(fprintf(fout, "%s\n\n", title.c_str()) > 0);
-    }
-
-    assert(description != "");
-    assert(fprintf(fout, "%s", description.c_str()) > 0);
-    assert(fprintf(fout, "\n\n") > 0);
-
-    assert(fprintf(fout, "Tableau rows x cols: %lu x %lu\n\n", tableau->getRows(), tableau->getCols()) > 0);
-
-    assert(fprintf(fout, "OBJECTIVE FUNCTION VALUE:\n") > 0);
-    assert(fprintf(fout, "%s\n\n", getFormattedComplex(-tableau->objFunc).c_str()) > 0);
+    outBuffer.clear();
+    appendTableauHeader(caption, description, title);
 
     if (tableau->getCols() > 0) {
-        assert(fprintf(fout, "          d") > 0);
-        for (Eigen::Index i = 0U; i < COMPLEX_LENGTH - 1; i++) {
-            assert(fprintf(fout, " ") > 0);
-        }
+        outBuffer.append("          d");
+        outBuffer.append(COMPLEX_LENGTH - 1, ' ');
     }
     for (Eigen::Index j = 1; j < tableau->getCols(); j++) {
-        assert(fprintf(fout, "    x%-5lu", j) > 0);
-        for (Eigen::Index i = 6U; i < REAL_LENGTH; i++) {
-            assert(fprintf(fout, " ") > 0);
-        }
+        appendPrintf(outBuffer, "    x%-5lu", j);
+        outBuffer.append(REAL_LENGTH - 6, ' ');
     }
 
-    assert(fprintf(fout, "\nc     ") > 0);
-    assert(fprintf(fout, "    %s", getFormattedComplex(tableau->objFunc).c_str()) > 0);
+    outBuffer.append("\nc     ");
+    outBuffer.append("    ");
+    appendFormattedComplex(outBuffer, tableau->objFunc);
     for (Eigen::Index j = 0; j < tableau->getN(); j++) {
-        assert(fprintf(fout, "    %s", getFormattedDouble(tableau->redCostsRow[j]).c_str()) > 0);
+        outBuffer.append("    ");
+        appendFormattedDouble(outBuffer, tableau->redCostsRow[j]);
     }
 
+    Eigen::Block<Eigen::MatrixXd> coeffMatrix = tableau->coeffMatrix();
     for (Eigen::Index i = 0; i < tableau->getM(); i++) {
         if (tableau->varInBaseCol[i] == 0) {
-            assert(fprintf(fout, "\n?     ") > 0);
+            outBuffer.append("\n?     ");
         } else {
-            assert(fprintf(fout, "\nx%-5lu", tableau->varInBaseCol[i]) > 0);
+            appendPrintf(outBuffer, "\nx%-5lu", tableau->varInBaseCol[i]);
         }
-        assert(fprintf(fout, "    %s", getFormattedComplex(tableau->knownTermsCol[i]).c_str()) > 0);
+        outBuffer.append("    ");
+        appendFormattedComplex(outBuffer, tableau->knownTermsCol[i]);
         for (Eigen::Index j = 0; j < tableau->getN(); j++) {
-            assert(fprintf(fout, "    %s", getFormattedDouble(tableau->coeffMatrix(i, j)).c_str()) > 0);
+            outBuffer.append("    ");
+            appendFormattedDouble(outBuffer, coeffMatrix(i, j));
+        }
+    }
+    outBuffer.push_back('\n');
+
+    writeOutBuffer(filename);
+}
+
+void TableauFilesManager::printSolution(const string& status, const string& description) {
+    if (outputFormat == OutputFormat::TABLEAU) {
+        printTableau(description, "SOLUTION");
+        return;
+    } else if (outputFormat == OutputFormat::NONE) {
+        return;
+    }
+
+    // Values of the variables in base sorted by variable, the others are 0
+    // As for the objective function, the multiple of big M of a value (if any) is written apart as xN_M
+    vector<pair<Eigen::Index, Eigen::Index>> baseRows;
+    for (Eigen::Index i = 0; i < tableau->getM(); i++) {
+        if (tableau->varInBaseCol[i] > 0) {
+            baseRows.push_back(make_pair(tableau->varInBaseCol[i], i));
+        }
+    }
+    sort(baseRows.begin(), baseRows.end());
+
+    outBuffer.clear();
+    if (outputFormat == OutputFormat::CSV) {
+        outBuffer.append("name,value\n");
+        outBuffer.append("status,").append(status).push_back('\n');
+        outBuffer.append("objective,");
+        appendExactDouble(outBuffer, -tableau->objFunc.real());
+        outBuffer.append("\nobjective_M,");
+        appendExactDouble(outBuffer, -tableau->objFunc.imag());
+        outBuffer.push_back('\n');
+        for (const auto& [var, i] : baseRows) {
+            appendPrintf(outBuffer, "x%lu,", var);
+            appendExactDouble(outBuffer, tableau->knownTermsCol[i].real());
+            outBuffer.push_back('\n');
+            if (tableau->knownTermsCol[i].imag() != 0.0) {
+                appendPrintf(outBuffer, "x%lu_M,", var);
+                appendExactDouble(outBuffer, tableau->knownTermsCol[i].imag());
+                outBuffer.push_back('\n');
+            }
         }
+    } else {
+        outBuffer.append("{\n  \"status\": \"").append(status).append("\",\n");
+        outBuffer.append("  \"objective\": ");
+        appendExactDouble(outBuffer, -tableau->objFunc.real());
+        outBuffer.append(",\n  \"objective_M\": ");
+        appendExactDouble(outBuffer, -tableau->objFunc.imag());
+        outBuffer.append(",\n  \"variables\": {");
+        for (size_t k = 0; k < baseRows.size(); k++) {
+            const Eigen::dcomplex value = tableau->knownTermsCol[baseRows[k].second];
+            appendPrintf(outBuffer, "%s\n    \"x%lu\": ", k == 0 ? "" : ",", baseRows[k].first);
+            appendExactDouble(outBuffer, value.real());
+            if (value.imag() != 0.0) {
+                appendPrintf(outBuffer, ",\n    \"x%lu_M\": ", baseRows[k].first);
+                appendExactDouble(outBuffer, value.imag());
+            }
+        }
+        outBuffer.append(baseRows.empty() ? "}\n}\n" : "\n  }\n}\n");
+    }
+
+    writeOutBuffer(outFolderPath + "/" + FILES_OUT_SOLUTION
+        + (outputFormat == OutputFormat::CSV ? FILES_OUT_CSV_EXTENSION : FILES_OUT_JSON_EXTENSION));
+}
+
+// Writes a single line: error and the message (a single word), in place of the solution of a problem
+void TableauFilesManager::writeErrorRecord(FILE *fout, const string& message) {
+    fprintf(fout, "error %s\n", message.c_str());
+    fflush(fout);
+}
+
+// Writes a single line: status, objective function value (real and big M parts), m and the variables in base
+void TableauFilesManager::writeSolutionRecord(FILE *fout, const string& status) {
+    outBuffer.clear();
+    outBuffer.append(status).push_back(' ');
+    appendExactDouble(outBuffer, -tableau->objFunc.real());
+    outBuffer.push_back(' ');
+    appendExactDouble(outBuffer, -tableau->objFunc.imag());
+    appendPrintf(outBuffer, " %ld", tableau->getM());
+    for (Eigen::Index i = 0; i < tableau->getM(); i++) {
+        appendPrintf(outBuffer, " %ld", tableau->varInBaseCol[i]);
     }
-    assert(fprintf(fout, "\n") > 0);
+    outBuffer.push_back('\n');
 
-    assert(fclose(fout) == 0);
+    fwrite(outBuffer.data(), sizeof(char), outBuffer.size(), fout);
+    fflush(fout);
 }
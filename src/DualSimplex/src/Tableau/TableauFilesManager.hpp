@@ -2,23 +2,51 @@
 #define __TABLEAU_FILES_MANAGER__HPP
 
 #include "Tableau.hpp"
+#include <cstdio>
 #include <string>
+#include <vector>
+
+// TABLEAU writes every step as tableau_N files, CSV and JSON only the final solution, NONE nothing
+enum class OutputFormat { TABLEAU, CSV, JSON, NONE };
+
+// Result of reading a problem from a stream: END if the stream is over before the problem starts
+enum class TableauReadStatus { READ, END, MALFORMED };
 
 class TableauFilesManager {
 
 public:
-    TableauFilesManager(Tableau *const tableau, const char *filePath);
-    void readTableau(void);
+    TableauFilesManager(Tableau *const tableau, const char *filePath, const OutputFormat outputFormat = OutputFormat::TABLEAU);
+    // Writes in outFolderPath (created if needed) continuing the files numbering of other
+    TableauFilesManager(Tableau *const tableau, const TableauFilesManager& other, const std::string& outFolderPath,
+                        const OutputFormat outputFormat);
+    // Reads problems from streams and writes no file
+    TableauFilesManager(Tableau *const tableau);
+    const std::string& getOutFolderPath(void) const { return outFolderPath; }
+    // Reads the file (.mps or .dat by extension), MALFORMED if it is refused (the reason is written on stderr)
+    TableauReadStatus readTableau(void);
+    TableauReadStatus readTableau(FILE *fin);
     const std::string getNextFilename(void);
     void printTableau(const std::string& description, const std::string& title = "", const std::string& filename = "");
+    void printSolution(const std::string& status, const std::string& description);
+    void writeSolutionRecord(FILE *fout, const std::string& status);
+    void writeErrorRecord(FILE *fout, const std::string& message);
     ~TableauFilesManager(void) { }
 
 private:
     const char *inFilePath;
+    std::string outFolderPath;
     std::string outPartialFilePath;
     unsigned long counter = 1;
     Tableau *tableau;
+    OutputFormat outputFormat;
+    // Reused by every print so that a file is written with a single write
+    std::string outBuffer;
 
+    TableauReadStatus readDatTableau(FILE *fin);
+    TableauReadStatus readMpsTableau(void);
+    void addSlackOrSurplus(const std::vector<double>& slackOrSurplus, const Eigen::Index n);
+    void appendTableauHeader(const std::string& caption, const std::string& description, const std::string& title);
+    void writeOutBuffer(const std::string& filename);
     void printTableauShort(const std::string& caption, const std::string& description,
                            const std::string& title, const std::string& filename);
 
@@ -1,15 +1,61 @@
 #include "utils.hpp"
 #include "DualSolver.hpp"
+#include "RaceSolver.hpp"
+#include "DualDaemon.hpp"
 #include <stdlib.h>
+#include <csignal>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace fs = std::filesystem;
 
+static DualSolverOptions options;
+static CancellationToken cancellationToken;
+// Number of configurations raced on each file, 0 means no race
+static unsigned long raceCount = 0;
+static unsigned int daemonWorkers = 1;
+
+// Ctrl+C stops the current solve at the next iteration (and the files after it)
+extern "C" void cancelDualSimplex(int) {
+    cancellationToken.cancel();
+}
+
+inline void printProgress(const DualSolverProgress& progress) {
+    std::cerr << "Iteration " << progress.iteration
+              << ": objective " << progress.objFunc.real() << " + " << progress.objFunc.imag() << "M"
+              << ", primal infeasibility " << progress.primalInfeasibility.real()
+              << " + " << progress.primalInfeasibility.imag() << "M" << std::endl;
+}
+
 inline void executeDualSimplex(const char *filePath) {
-    DualSolver tableau(filePath);
-    tableau.startDualSimplex();
+    if (cancellationToken.isCancelled()) {
+        return;
+    }
+    if (raceCount > 0) {
+        // The options as specified, then the other row selection rules and random seeds
+        std::vector<DualSolverOptions> configurations(raceCount, options);
+        for (unsigned long k = 1; k < raceCount; k++) {
+            if (k == 1 && options.rowSelectionRule != RowSelectionRule::DANTZIG) {
+                configurations[k].rowSelectionRule = RowSelectionRule::DANTZIG;
+            } else {
+                configurations[k].rowSelectionRule = RowSelectionRule::RANDOM;
+                configurations[k].seed = options.seed + k;
+            }
+        }
+        RaceSolver race(filePath, configurations);
+        if (race.isLoaded()) {
+            race.startRace();
+        }
+    } else {
+        DualSolver tableau(filePath, options);
+        if (tableau.isLoaded()) {
+            tableau.startDualSimplex();
+        }
+    }
 }
 
 inline void filesExecuteDualSimplex(const char *path) {
@@ -26,9 +72,67 @@ inline void filesExecuteDualSimplex(const char *path) {
     }
 }
 
+// Options start with "--" and apply to every file specified after them
+inline bool parseOption(const char *arg) {
+    if (strncmp(arg, "--", 2) != 0) {
+        return false;
+    }
+
+    if (strcmp(arg, "--mixed-precision") == 0) {
+        options.mixedPrecision = true;
+    } else if (strcmp(arg, "--sparse-pivot") == 0) {
+        options.sparsePivot = true;
+    } else if (strcmp(arg, "--partial-pricing") == 0) {
+        options.partialPricing = true;
+    } else if (strcmp(arg, "--perturb-costs") == 0) {
+        options.perturbCosts = true;
+    } else if (strncmp(arg, "--max-iterations=", 17) == 0) {
+        options.maxIterations = strtoul(arg + 17, NULL, 10);
+    } else if (strncmp(arg, "--time-limit=", 13) == 0) {
+        options.timeLimitSeconds = strtod(arg + 13, NULL);
+    } else if (strncmp(arg, "--progress=", 11) == 0) {
+        options.progressPeriod = MAX(strtoul(arg + 11, NULL, 10), 1UL);
+        options.progressCallback = printProgress;
+    } else if (strcmp(arg, "--row-rule=bland") == 0) {
+        options.rowSelectionRule = RowSelectionRule::BLAND;
+    } else if (strcmp(arg, "--row-rule=dantzig") == 0) {
+        options.rowSelectionRule = RowSelectionRule::DANTZIG;
+    } else if (strcmp(arg, "--row-rule=random") == 0) {
+        options.rowSelectionRule = RowSelectionRule::RANDOM;
+    } else if (strncmp(arg, "--seed=", 7) == 0) {
+        options.seed = strtoul(arg + 7, NULL, 10);
+    } else if (strcmp(arg, "--race") == 0) {
+        raceCount = MIN(MAX(std::thread::hardware_concurrency(), 2U), 4U);
+    } else if (strncmp(arg, "--race=", 7) == 0) {
+        raceCount = strtoul(arg + 7, NULL, 10);
+    } else if (strncmp(arg, "--workers=", 10) == 0) {
+        daemonWorkers = strtoul(arg + 10, NULL, 10);
+    } else if (strcmp(arg, "--daemon") == 0) {
+        DualDaemon daemon(options);
+        daemon.serveStream(stdin, stdout);
+    } else if (strncmp(arg, "--daemon=", 9) == 0) {
+        DualDaemon daemon(options, daemonWorkers);
+        daemon.serveSocket(arg + 9);
+    } else if (strcmp(arg, "--output=tableau") == 0) {
+        options.outputFormat = OutputFormat::TABLEAU;
+    } else if (strcmp(arg, "--output=csv") == 0) {
+        options.outputFormat = OutputFormat::CSV;
+    } else if (strcmp(arg, "--output=json") == 0) {
+        options.outputFormat = OutputFormat::JSON;
+    } else {
+        std::cerr << "Unknown option '" << arg << "' ignored." << std::endl;
+    }
+    return true;
+}
+
 int main(int argc, char** argv) {
+    options.cancellationToken = &cancellationToken;
+    signal(SIGINT, cancelDualSimplex);
+
     for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "*") == 0) {
+        if (parseOption(argv[i])) {
+            continue;
+        } else if (strcmp(argv[i], "*") == 0) {
             filesExecuteDualSimplex(FILES_IN_PATH);
         } else if (fs::exists(argv[i])) {
             filesExecuteDualSimplex(argv[i]);
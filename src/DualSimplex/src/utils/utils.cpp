@@ -1,6 +1,9 @@
 #include "utils.hpp"
-#include <sstream>
-#include <iomanip>
+#include <assert.h>
+#include <cfloat>
+#include <charconv>
+#include <cstdarg>
+#include <cstdio>
 #include <regex>
 
 /*
@@ -18,71 +21,69 @@ std::string getFileNameWithoutExtension(const std::string& input) {
     }
 }
 
-std::string getFormattedComplex(const Eigen::dcomplex& num) {
-    std::string real;
-    if (num.real() == 0.0) {
-        real = "0";
-    } else {
-        std::stringstream ss1;
-        ss1 << std::fixed << std::setprecision(PRECISION) << num.real();
-        real = ss1.str();
+// Appends num with PRECISION decimal digits ("0" if it is exactly zero), returns the number of characters appended
+static size_t appendFixed(std::string& buffer, const double& num) {
+    if (num == 0.0) {
+        buffer.push_back('0');
+        return 1;
     }
+    // Enough for the longest double in fixed notation
+    char tmp[DBL_MAX_10_EXP + PRECISION + 4];
+    const std::to_chars_result result = std::to_chars(tmp, tmp + sizeof(tmp), num, std::chars_format::fixed, PRECISION);
+    assert(result.ec == std::errc());
+    buffer.append(tmp, result.ptr);
+    return result.ptr - tmp;
+}
 
-    if (num.imag() == 0.0) {
-        if (real.length() < COMPLEX_LENGTH) {
-            real = real + std::string(COMPLEX_LENGTH - real.length(), ' ');
-        }
-        return real;
-    } else if (num.real() == 0.0) {
-        std::stringstream ss2;
-        ss2 << std::fixed << std::setprecision(PRECISION) << num.imag() << "M";
-        std::string imag = ss2.str();
-
-        if (imag.length() < COMPLEX_LENGTH) {
-            imag = imag + std::string(COMPLEX_LENGTH - imag.length(), ' ');
-        }
-        return imag;
+static void appendPadding(std::string& buffer, const size_t length, const size_t width) {
+    if (length < width) {
+        buffer.append(width - length, ' ');
     }
+}
 
-    std::stringstream ss2;
-    ss2 << std::fixed << std::setprecision(PRECISION) << abs(num.imag());
-    std::string imag = ss2.str();
-
-    imag = imag + "M";
-
-    std::string result;
-    if (num.imag() > 0.0) {
-        result = real + " + " + imag;
+void appendFormattedComplex(std::string& buffer, const Eigen::dcomplex& num) {
+    size_t length;
+    if (num.imag() == 0.0) {
+        length = appendFixed(buffer, num.real());
+    } else if (num.real() == 0.0) {
+        length = appendFixed(buffer, num.imag());
+        buffer.push_back('M');
+        length++;
     } else {
-        result = real + " - " + imag;
+        length = appendFixed(buffer, num.real());
+        buffer.append(num.imag() > 0.0 ? " + " : " - ");
+        length += 3 + appendFixed(buffer, abs(num.imag()));
+        buffer.push_back('M');
+        length++;
     }
-    
-    if (result.length() < COMPLEX_LENGTH) {
-        result = result + std::string(COMPLEX_LENGTH - result.length(), ' ');
-    }
-    return result;
+    appendPadding(buffer, length, COMPLEX_LENGTH);
 }
 
-std::string getFormattedDouble(const double& num) {
-    std::string str;
-    if (num == 0.0) {
-        str = "0";
-    } else {
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(PRECISION) << num;
-        str = ss.str();
-    }
+void appendFormattedDouble(std::string& buffer, const double& num) {
+    appendPadding(buffer, appendFixed(buffer, num), REAL_LENGTH);
+}
 
-    if (str.length() < REAL_LENGTH) {
-        str = str + std::string(REAL_LENGTH - str.length(), ' ');
-    }
-    
-    return str;
+// Appends num with the shortest representation that reads back the same value (no negative zero)
+void appendExactDouble(std::string& buffer, const double& num) {
+    char tmp[32];
+    const std::to_chars_result result = std::to_chars(tmp, tmp + sizeof(tmp), num == 0.0 ? 0.0 : num);
+    assert(result.ec == std::errc());
+    buffer.append(tmp, result.ptr);
+}
+
+void appendPrintf(std::string& buffer, const char *format, ...) {
+    char tmp[256];
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(tmp, sizeof(tmp), format, args);
+    va_end(args);
+    assert(length >= 0 && static_cast<size_t>(length) < sizeof(tmp));
+    buffer.append(tmp, length);
 }
 
 // Uses Gauss-Jordan Elimination algorithm to determine linearly dependent rows
-std::vector<Eigen::Index> getDependentRows(const Eigen::MatrixXd& matrix) {
-    Eigen::MatrixXd mat = matrix; // Make a copy to avoid modifying the original matrix
+// The matrix (or block of a matrix) is overwritten by the elimination
+std::vector<Eigen::Index> getDependentRows(Eigen::Ref<Eigen::MatrixXd> mat) {
     Eigen::Index numRows = mat.rows();
     Eigen::Index numCols = mat.cols();
     std::vector<Eigen::Index> dependentIndices;
@@ -139,6 +140,17 @@ bool complexIsNotZero(const Eigen::dcomplex& value) {
     return (value.real() != 0.0) || (value.imag() != 0.0);
 }
 
+// The imaginary part (multiple of big M) prevails over the real one
+bool complexIsLessThanZero(const Eigen::dcomplex& value, const double& tolerance) {
+    return isLessThanZero(value.imag(), tolerance)
+        || (isZero(value.imag(), tolerance) && isLessThanZero(value.real(), tolerance));
+}
+
+// Exact comparison, the imaginary part (multiple of big M) prevails over the real one
+bool complexIsLess(const Eigen::dcomplex& a, const Eigen::dcomplex& b) {
+    return (a.imag() < b.imag()) || ((a.imag() == b.imag()) && (a.real() < b.real()));
+}
+
 bool isZero(const double& value, const double& tolerance) {
     return std::fabs(value) < tolerance;
 }
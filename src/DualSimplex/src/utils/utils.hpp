@@ -14,6 +14,23 @@
 #define FILES_OUT_PREFIX "tableau_"
 #define FILES_OUT_EXTENSION ".txt"
 
+// Solution only output files
+#define FILES_OUT_SOLUTION "solution"
+#define FILES_OUT_CSV_EXTENSION ".csv"
+#define FILES_OUT_JSON_EXTENSION ".json"
+
+// Race mode: every configuration writes in a sub folder of the output one, only the winner files are kept
+#define FILES_OUT_RACE_PREFIX "race_"
+#define RACE_POLL_MILLISECONDS 5
+
+// Daemon mode: period with which the cancellation is checked while waiting for connections
+#define DAEMON_POLL_MILLISECONDS 100
+// A connection on which no data arrives for this long is replied with a timeout error record and closed
+#define DAEMON_IDLE_TIMEOUT_SECONDS 10
+
+// Input formats (selected by file extension, anything else is read as .dat)
+#define FILES_IN_MPS_EXTENSION ".mps"
+
 // Output tableau format
 #define PRECISION 2
 #define COMPLEX_LENGTH 20
@@ -21,6 +38,23 @@
 
 #define DEFAULT_TOLERANCE 1e-6
 
+// Cost perturbation: each cost out of base is increased by BASE * (1..2) * max(1, max |column coefficient|)
+#define COST_PERTURBATION_BASE 1e-5
+
+// Sparse pivot: only the columns with a nonzero in the pivot row are updated if they are at most this fraction of all
+#define SPARSE_PIVOT_MAX_DENSITY 0.5
+
+// Partial pricing: a full scan of the rows keeps the best CANDIDATES infeasible ones, used for at most PERIOD iterations
+#define PARTIAL_PRICING_CANDIDATES 16
+#define PARTIAL_PRICING_PERIOD 16
+
+// Mixed precision solve: a refinement costs about as m pivots, so it is done every max(PERIOD, m) pivots
+#define MIXED_PRECISION_TOLERANCE 1e-4
+#define MIXED_PRECISION_MAX_DRIFT 1e-2
+// Reciprocal condition number estimate of the base under which it is considered singular
+#define MIXED_PRECISION_MIN_RCOND 1e-12
+#define MIXED_PRECISION_REFINEMENT_PERIOD 50
+
 #define XOR_SWAP(X, Y)  {\
                             (X) ^= (Y);\
                             (Y) ^= (X);\
@@ -50,13 +84,17 @@ void swap(T& a, T& b)
 
 std::string getFileNameWithoutExtension(const std::string& input);
 
-std::string getFormattedComplex(const Eigen::dcomplex& num);
-std::string getFormattedDouble(const double& num);
+void appendFormattedComplex(std::string& buffer, const Eigen::dcomplex& num);
+void appendFormattedDouble(std::string& buffer, const double& num);
+void appendExactDouble(std::string& buffer, const double& num);
+void appendPrintf(std::string& buffer, const char *format, ...);
 
-std::vector<Eigen::Index> getDependentRows(const Eigen::MatrixXd& matrix);
+std::vector<Eigen::Index> getDependentRows(Eigen::Ref<Eigen::MatrixXd> mat);
 
 bool complexIsZero(const Eigen::dcomplex& value);
 bool complexIsNotZero(const Eigen::dcomplex& value);
+bool complexIsLessThanZero(const Eigen::dcomplex& value, const double& tolerance = DEFAULT_TOLERANCE);
+bool complexIsLess(const Eigen::dcomplex& a, const Eigen::dcomplex& b);
 
 bool isZero(const double& value, const double& tolerance = DEFAULT_TOLERANCE);
 bool isNotZero(const double& value, const double& tolerance = DEFAULT_TOLERANCE);